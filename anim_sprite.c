@@ -0,0 +1,88 @@
+#include <stdint.h>
+#include "anim_sprite.h"
+
+
+/* Spinner (dot going round a ring of 8, 1 turn per 800ms) */
+static const uint8_t spinner_frames[] =
+{
+    /* Frame 0 */
+    0b00001000,  //      *
+    0b00100010,  //    *   *
+    0x00      ,  //
+    0b01000011,  //   *    **
+    0b00000011,  //        **
+    0b00100010,  //    *   *
+    0b00001000,  //      *
+    0x00      ,  //
+    /* Frame 1 */
+    0b00001000,  //      *
+    0b00100010,  //    *   *
+    0x00      ,  //
+    0b01000001,  //   *     *
+    0x00      ,  //
+    0b00100110,  //    *  **
+    0b00001110,  //      ***
+    0x00      ,  //
+    /* Frame 2 */
+    0b00001000,  //      *
+    0b00100010,  //    *   *
+    0x00      ,  //
+    0b01000001,  //   *     *
+    0x00      ,  //
+    0b00100010,  //    *   *
+    0b00011000,  //     **
+    0b00011000,  //     **
+    /* Frame 3 */
+    0b00001000,  //      *
+    0b00100010,  //    *   *
+    0x00      ,  //
+    0b01000001,  //   *     *
+    0x00      ,  //
+    0b01100010,  //   **   *
+    0b01101000,  //   ** *
+    0x00      ,  //
+    /* Frame 4 */
+    0b00001000,  //      *
+    0b00100010,  //    *   *
+    0x00      ,  //
+    0b11000001,  //  **     *
+    0b11000000,  //  **
+    0b00100010,  //    *   *
+    0b00001000,  //      *
+    0x00      ,  //
+    /* Frame 5 */
+    0b00001000,  //      *
+    0b01100010,  //   **   *
+    0b01100000,  //   **
+    0b01000001,  //   *     *
+    0x00      ,  //
+    0b00100010,  //    *   *
+    0b00001000,  //      *
+    0x00      ,  //
+    /* Frame 6 */
+    0b00011000,  //     **
+    0b00111010,  //    *** *
+    0x00      ,  //
+    0b01000001,  //   *     *
+    0x00      ,  //
+    0b00100010,  //    *   *
+    0b00001000,  //      *
+    0x00      ,  //
+    /* Frame 7 */
+    0b00001000,  //      *
+    0b00100110,  //    *  **
+    0b00000110,  //       **
+    0b01000001,  //   *     *
+    0x00      ,  //
+    0b00100010,  //    *   *
+    0b00001000,  //      *
+    0x00         //
+};
+
+const anim_sprite_t anim_spinner =
+{
+    spinner_frames,
+    8,
+    8,
+    2,
+};
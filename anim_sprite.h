@@ -0,0 +1,37 @@
+#ifndef _ANIM_SPRITE_H
+#define _ANIM_SPRITE_H
+
+#include <stdint.h>
+
+
+/* Sprite (also used by tools/anim_cost.c, no device header) */
+/*---------------------------------------------------
+ Frames are stored one after another, each frame is
+ width columns of graphic mode (bit0 : top).
+ Frame i starts at p_frames[i x width].
+---------------------------------------------------*/
+typedef struct
+{
+    const uint8_t *p_frames;
+    uint8_t width;              // ANIM_SPRITE_WIDTH_MAX max
+    uint8_t frame_num;
+    uint8_t frame_ticks;        // Frame period [ANIM_TICK_MS]
+} anim_sprite_t;
+
+
+/* Animation Timing */
+#define ANIM_TICK_MS            (50)
+#define ANIM_SPRITE_WIDTH_MAX   (8)
+#define ANIM_COLUMN_BUDGET      (12)    // Columns written per tick, all slots
+
+
+/* Countdown Bar Column */
+#define ANIM_BAR_FULL   (0b00111100)
+#define ANIM_BAR_EMPTY  (0b00100100)
+
+
+/* Sprites (anim_sprite.c) */
+extern const anim_sprite_t anim_spinner;     // 8 x 8, dot going round a ring
+
+
+#endif  /* _ANIM_SPRITE_H */
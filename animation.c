@@ -0,0 +1,329 @@
+#include <xc.h>
+#include "animation.h"
+#include "oled_lcd_lib.h"
+#include "pic_clock.h"
+#include "systick.h"
+#include "timer_wheel.h"
+#include "transition.h"
+#include "perf.h"
+
+
+/* Kind of Slot */
+typedef enum
+{
+    ANIM_KIND_NONE,
+    ANIM_KIND_SPRITE,
+    ANIM_KIND_COUNTDOWN,
+} anim_kind_t;
+
+
+/* Slot */
+typedef struct
+{
+    anim_kind_t kind;
+    uint8_t x;
+    uint8_t line;
+
+    /* Sprite */
+    const anim_sprite_t *p_sprite;
+    uint8_t frame;
+    uint8_t frame_tick;
+    uint8_t shown[ANIM_SPRITE_WIDTH_MAX];   // Columns on the display
+
+    /* Countdown */
+    uint8_t  width;
+    uint8_t  shown_fill;                    // ANIM_BAR_FULL columns on the display
+    uint16_t ticks;
+    uint32_t start_tick;
+} anim_data_t;
+
+
+/* Prototype of Static Function */
+static uint8_t flush_sprite(anim_data_t *p_anim, uint8_t budget);
+static uint8_t flush_countdown(anim_data_t *p_anim, uint8_t budget);
+static void put_column(uint8_t x, uint8_t line, uint8_t data);
+
+
+static anim_data_t anim[ANIM_SLOT_NUM];
+static uint8_t first_slot;          // Served first in the tick (round robin)
+static uint8_t bus_x;               // x address incremented by LCD, 0xFF : not set
+static uint8_t bus_line;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Animation
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void anim_init(void)
+{
+    uint8_t i;
+
+    for(i = 0; i < ANIM_SLOT_NUM; i++)
+    {
+        anim[i].kind = ANIM_KIND_NONE;
+    }
+    first_slot = 0;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Play Sprite (repeated until anim_stop())
+ * @param
+ *     slot    :animation slot
+ *     p_sprite:sprite in flash
+ *     x       :x address (0 - 99)
+ *     line    :y address (0 - 1)
+ * @return
+ *     none:
+ * @note
+ *     Area must be blank (after the screen is drawn)
+ *===================================================*/
+void anim_play(anim_slot_t slot, const anim_sprite_t *p_sprite, uint8_t x, uint8_t line)
+{
+    anim_data_t *p_anim = &anim[slot];
+    uint8_t i;
+
+    p_anim->kind       = ANIM_KIND_SPRITE;
+    p_anim->x          = x;
+    p_anim->line       = line;
+    p_anim->p_sprite   = p_sprite;
+    p_anim->frame      = 0;
+    p_anim->frame_tick = 0;
+    for(i = 0; i < ANIM_SPRITE_WIDTH_MAX; i++)
+    {
+        p_anim->shown[i] = 0x00;
+    }
+
+    /* First frame is drawn at the next tick */
+    timer_start(TIMER_ANIM, 0);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Show Countdown Bar
+ * @param
+ *     slot :animation slot
+ *     x    :x address (0 - 99)
+ *     line :y address (0 - 1)
+ *     width:number of columns
+ *     ticks:time to count down [SYSTICK_PERIOD_MS]
+ * @return
+ *     none:
+ * @note
+ *     Area must be blank. Bar is filled first, then
+ *     shrinks from the right as time passes
+ *===================================================*/
+void anim_countdown(anim_slot_t slot, uint8_t x, uint8_t line, uint8_t width, uint16_t ticks)
+{
+    anim_data_t *p_anim = &anim[slot];
+
+    p_anim->kind       = ANIM_KIND_COUNTDOWN;
+    p_anim->x          = x;
+    p_anim->line       = line;
+    p_anim->width      = width;
+    p_anim->shown_fill = 0;
+    p_anim->ticks      = (ticks == 0) ? 1 : ticks;
+    p_anim->start_tick = systick_get();
+
+    timer_start(TIMER_ANIM, 0);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Stop All Animations
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Display is left as it is
+ *===================================================*/
+void anim_stop(void)
+{
+    timer_stop(TIMER_ANIM);
+    anim_init();
+}
+
+
+/*=====================================================
+ * @brief
+ *     Animation Task (called from main loop)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Writes changed columns at each TIMER_ANIM tick,
+ *     after the transition of the screen
+ *===================================================*/
+void anim_task(void)
+{
+    anim_data_t *p_anim;
+    uint8_t budget;
+    uint8_t slot;
+    uint8_t i;
+
+    /* Tick is kept until the wipe has written the animation area */
+    if(transition_busy() || (timer_expired(TIMER_ANIM) == 0))
+    {
+        return;
+    }
+    timer_start(TIMER_ANIM, TIMER_TICKS(ANIM_TICK_MS));
+
+    clock_set_mode(CLOCK_MODE_FAST);
+    PERF_BEGIN(PERF_ANIM_FRAME);
+
+    budget   = ANIM_COLUMN_BUDGET;
+    bus_x    = 0xFF;
+    bus_line = 0xFF;
+    slot     = first_slot;
+    for(i = 0; i < ANIM_SLOT_NUM; i++)
+    {
+        p_anim = &anim[slot];
+        if(p_anim->kind == ANIM_KIND_SPRITE)
+        {
+            budget -= flush_sprite(p_anim, budget);
+        }
+        else if(p_anim->kind == ANIM_KIND_COUNTDOWN)
+        {
+            budget -= flush_countdown(p_anim, budget);
+        }
+
+        if(++slot == ANIM_SLOT_NUM)
+        {
+            slot = 0;
+        }
+    }
+    if(++first_slot == ANIM_SLOT_NUM)
+    {
+        first_slot = 0;
+    }
+
+    PERF_END(PERF_ANIM_FRAME);
+    clock_set_mode(CLOCK_MODE_IDLE);
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Advance Sprite and Write Changed Columns
+ * @param
+ *     p_anim:slot
+ *     budget:columns left in this tick
+ * @return
+ *     columns written
+ * @note
+ *     Frame advances even if the last one is not
+ *     written completely
+ *---------------------------------------------------*/
+static uint8_t flush_sprite(anim_data_t *p_anim, uint8_t budget)
+{
+    const anim_sprite_t *p_sprite = p_anim->p_sprite;
+    const uint8_t *p_column;
+    uint8_t used = 0;
+    uint8_t c;
+
+    if(++p_anim->frame_tick >= p_sprite->frame_ticks)
+    {
+        p_anim->frame_tick = 0;
+        if(++p_anim->frame >= p_sprite->frame_num)
+        {
+            p_anim->frame = 0;
+        }
+    }
+
+    p_column = &p_sprite->p_frames[(uint16_t)p_anim->frame * p_sprite->width];
+    for(c = 0; (c < p_sprite->width) && (used < budget); c++)
+    {
+        if(p_column[c] != p_anim->shown[c])
+        {
+            put_column((uint8_t)(p_anim->x + c), p_anim->line, p_column[c]);
+            p_anim->shown[c] = p_column[c];
+            used++;
+        }
+    }
+
+    return used;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Move Countdown Bar to the Time Left
+ * @param
+ *     p_anim:slot
+ *     budget:columns left in this tick
+ * @return
+ *     columns written
+ * @note
+ *     none
+ *---------------------------------------------------*/
+static uint8_t flush_countdown(anim_data_t *p_anim, uint8_t budget)
+{
+    uint32_t elapsed;
+    uint8_t  target;
+    uint8_t  used = 0;
+
+    elapsed = systick_get() - p_anim->start_tick;
+    if(elapsed > p_anim->ticks)
+    {
+        elapsed = p_anim->ticks;
+    }
+    target = (uint8_t)(((uint32_t)p_anim->width * (p_anim->ticks - elapsed)) / p_anim->ticks);
+
+    while((p_anim->shown_fill != target) && (used < budget))
+    {
+        if(p_anim->shown_fill < target)
+        {
+            put_column((uint8_t)(p_anim->x + p_anim->shown_fill), p_anim->line, ANIM_BAR_FULL);
+            p_anim->shown_fill++;
+        }
+        else
+        {
+            p_anim->shown_fill--;
+            put_column((uint8_t)(p_anim->x + p_anim->shown_fill), p_anim->line, ANIM_BAR_EMPTY);
+        }
+        used++;
+    }
+
+    return used;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Write 1 Column
+ * @param
+ *     x   :x address (0 - 99)
+ *     line:y address (0 - 1)
+ *     data:graphic data
+ * @return
+ *     none:
+ * @note
+ *     Address is set only if the LCD is not already
+ *     there (x is incremented by LCD after data)
+ *---------------------------------------------------*/
+static void put_column(uint8_t x, uint8_t line, uint8_t data)
+{
+    if(line != bus_line)
+    {
+        lcd_write((uint8_t)(0b01000000 | line), WRITE_COMMAND_REG);
+        bus_line = line;
+        bus_x    = 0xFF;
+    }
+    if(x != bus_x)
+    {
+        lcd_write((uint8_t)(0b10000000 | x), WRITE_COMMAND_REG);
+    }
+    lcd_write(data, WRITE_DATA_REG);
+    bus_x = (uint8_t)(x + 1);
+}
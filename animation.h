@@ -0,0 +1,114 @@
+#ifndef _ANIMATION_H
+#define _ANIMATION_H
+
+#include <xc.h>
+#include <stdint.h>
+#include "anim_sprite.h"
+
+
+/* Animation Slot (1 animation each) */
+typedef enum
+{
+    ANIM_WAIT_SPINNER,      // Waiting for Responce
+    ANIM_WAIT_PROGRESS,     // Time left until TIMER_RESPONCE
+    ANIM_SLOT_NUM,
+} anim_slot_t;
+
+
+/* Animation Engine */
+/*---------------------------------------------------
+ Each TIMER_ANIM tick (ANIM_TICK_MS) advances the
+ frames and writes only the columns that differ from
+ what is on the display, ANIM_COLUMN_BUDGET columns at
+ most for all slots. Columns over the budget are
+ written at the next tick (frames are skipped rather
+ than delayed), so a tick never holds the main loop
+ longer than the budget and USART_RX_BUF_SIZE is not
+ overrun. Cost per frame is reported by
+ tools/anim_cost.c.
+
+| Kind      | Columns                                 |
+-----------------------------------------------------
+| Sprite    | Frames of anim_sprite_t in flash        |
+-----------------------------------------------------
+| Countdown | ANIM_BAR_FULL for time left,            |
+|           | ANIM_BAR_EMPTY for time passed          |
+---------------------------------------------------*/
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Animation
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void anim_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Play Sprite (repeated until anim_stop())
+ * @param
+ *     slot    :animation slot
+ *     p_sprite:sprite in flash
+ *     x       :x address (0 - 99)
+ *     line    :y address (0 - 1)
+ * @return
+ *     none:
+ * @note
+ *     Area must be blank (after the screen is drawn)
+ *===================================================*/
+void anim_play(anim_slot_t slot, const anim_sprite_t *p_sprite, uint8_t x, uint8_t line);
+
+
+/*=====================================================
+ * @brief
+ *     Show Countdown Bar
+ * @param
+ *     slot :animation slot
+ *     x    :x address (0 - 99)
+ *     line :y address (0 - 1)
+ *     width:number of columns
+ *     ticks:time to count down [SYSTICK_PERIOD_MS]
+ * @return
+ *     none:
+ * @note
+ *     Area must be blank. Bar is filled first, then
+ *     shrinks from the right as time passes
+ *===================================================*/
+void anim_countdown(anim_slot_t slot, uint8_t x, uint8_t line, uint8_t width, uint16_t ticks);
+
+
+/*=====================================================
+ * @brief
+ *     Stop All Animations
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Display is left as it is
+ *===================================================*/
+void anim_stop(void);
+
+
+/*=====================================================
+ * @brief
+ *     Animation Task (called from main loop)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Writes changed columns at each TIMER_ANIM tick,
+ *     after the transition of the screen
+ *===================================================*/
+void anim_task(void);
+
+
+#endif  /* _ANIMATION_H */
@@ -0,0 +1,287 @@
+#include <xc.h>
+#include "bootloader.h"
+#include "usart.h"
+
+
+/* Receive State */
+typedef enum
+{
+    BOOT_STATE_COMMAND,
+    BOOT_STATE_BAUD,
+    BOOT_STATE_ROW,
+} boot_state_t;
+
+
+/* Only register access is allowed in boot_main(), no function call */
+#define BOOT_PUT(data)                  \
+    do                                  \
+    {                                   \
+        while(PIR1bits.TXIF == 0)       \
+        {                               \
+            ;                           \
+        }                               \
+        TXREG = (data);                 \
+    } while(0)
+
+#define BOOT_FLASH_UNLOCK()             \
+    do                                  \
+    {                                   \
+        EECON2 = 0x55;                  \
+        EECON2 = 0xAA;                  \
+        EECON1bits.WR = 1;              \
+        asm("nop");                     \
+        asm("nop");                     \
+    } while(0)
+
+
+/*=====================================================
+ * @brief
+ *     Boot Loader
+ * @param
+ *     none:
+ * @return
+ *     none: (never returns, ends with reset)
+ * @note
+ *  Placed at BOOT_ADDRESS and self-contained: it calls
+ *  no other function and uses no const table, because
+ *  any other code may be rewritten while it runs.
+ *  Entered by PROTOCOL_BOOT + key (protocol.h), or
+ *  from reset while row 0 holds the jump (an update
+ *  was not finished).
+ *  Without any changed row, it returns to the
+ *  application after BOOT_TIMEOUT of silence.
+ *===================================================*/
+void boot_main(void) @ BOOT_ADDRESS
+{
+    uint8_t  row[BOOT_ROW_BYTES];
+    uint8_t  count;
+    uint8_t  data;
+    uint8_t  result;
+    uint8_t  stub_written;
+    uint8_t  pass;
+    uint8_t  i;
+    uint16_t address;
+    uint16_t target;
+    uint16_t word;
+    uint16_t crc;
+    uint16_t spbrg;
+    uint32_t wait;
+    boot_state_t state;
+
+    INTCONbits.GIE = 0;
+    WDTCONbits.SWDTEN = 0;      // Flash write and upload wait are not kicked
+
+    /* HFINTOSC 16MHz */
+    OSCCON = (OSCCON_IRCF_16M | OSCCON_SCS_INTOSC);
+    while(OSCSTATbits.HFIOFR == 0)
+    {
+        ;
+    }
+
+    /* EUSART 8bit, 9600bps */
+    TRISCbits.TRISC7 = 1;
+    RCSTA   = 0x00;
+    BAUDCON = BAUDCTL_BRG16;
+    spbrg   = BOOT_SPBRG(9600);
+    SPBRGH  = (uint8_t)(spbrg >> 8);
+    SPBRGL  = (uint8_t)spbrg;
+    TXSTA   = (TXSTA_TXEN | TXSTA_BRGH);
+    RCSTA   = (RCSTA_SPEN | RCSTA_CREN);
+
+    /* Row 0 is not the jump while the application is intact */
+    EEADRH = 0;
+    EEADRL = 1;
+    EECON1bits.CFGS  = 0;
+    EECON1bits.EEPGD = 1;
+    EECON1bits.RD    = 1;
+    asm("nop");
+    asm("nop");
+    stub_written = (((EEDATH << 8) | EEDATL) == BOOT_STUB_GOTO);
+
+    BOOT_PUT(BOOT_READY);
+    BOOT_PUT(BOOT_MAX_BAUD);
+
+    state = BOOT_STATE_COMMAND;
+    count = 0;
+    crc   = 0xFFFF;
+    while(1)
+    {
+        /* Receive 1 byte */
+        wait = 0;
+        while(PIR1bits.RCIF == 0)
+        {
+            if(RCSTAbits.OERR)
+            {
+                RCSTAbits.CREN = 0;
+                RCSTAbits.CREN = 1;
+            }
+            if((++wait >= BOOT_TIMEOUT) && (stub_written == 0))
+            {
+                /* Nothing changed, back to the application */
+                asm("reset");
+            }
+        }
+        data = RCREG;
+
+        switch(state)
+        {
+            case BOOT_STATE_COMMAND:
+                if(data == PROTOCOL_BOOT)
+                {
+                    BOOT_PUT(BOOT_READY);
+                    BOOT_PUT(BOOT_MAX_BAUD);
+                }
+                else if(data == BOOT_CMD_BAUD)
+                {
+                    state = BOOT_STATE_BAUD;
+                }
+                else if(data == BOOT_CMD_WRITE)
+                {
+                    state = BOOT_STATE_ROW;
+                    count = 0;
+                    crc   = 0xFFFF;
+                }
+                else if(data == BOOT_CMD_EXIT)
+                {
+                    BOOT_PUT(BOOT_READY);
+                    while((TXSTA & TXSTA_TRMT) == 0)
+                    {
+                        ;
+                    }
+                    asm("reset");
+                }
+                break;
+
+            case BOOT_STATE_BAUD:
+                if(data == BOOT_BAUD_115200)
+                {
+                    spbrg = BOOT_SPBRG(115200);
+                }
+                else if(data == BOOT_BAUD_57600)
+                {
+                    spbrg = BOOT_SPBRG(57600);
+                }
+                else
+                {
+                    spbrg = BOOT_SPBRG(9600);
+                }
+
+                /* Handset changes baudrate after 1 byte time */
+                while((TXSTA & TXSTA_TRMT) == 0)
+                {
+                    ;
+                }
+                SPBRGH = (uint8_t)(spbrg >> 8);
+                SPBRGL = (uint8_t)spbrg;
+                BOOT_PUT(BOOT_READY);
+                state = BOOT_STATE_COMMAND;
+                break;
+
+            case BOOT_STATE_ROW:
+                row[count++] = data;
+
+                /* CRC-16-CCITT of address and words */
+                if(count <= (BOOT_ROW_BYTES - 2))
+                {
+                    crc ^= (uint16_t)data << 8;
+                    for(i = 0; i < 8; i++)
+                    {
+                        crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+                    }
+                }
+                if(count < BOOT_ROW_BYTES)
+                {
+                    break;
+                }
+                state = BOOT_STATE_COMMAND;
+
+                address = ((uint16_t)row[0] << 8) | row[1];
+                if(crc != (((uint16_t)row[BOOT_ROW_BYTES - 2] << 8) | row[BOOT_ROW_BYTES - 1]))
+                {
+                    BOOT_PUT(BOOT_NAK_CRC);
+                    break;
+                }
+                if(((address & (BOOT_ROW_WORDS - 1)) != 0) || (address >= BOOT_ADDRESS))
+                {
+                    BOOT_PUT(BOOT_NAK_ADDRESS);
+                    break;
+                }
+
+                /* Pass 0 : skip unchanged row, Pass 1 : verify */
+                result = BOOT_SKIPPED;
+                for(pass = 0; pass < 2; pass++)
+                {
+                    EEADRH = (uint8_t)(address >> 8);
+                    EEADRL = (uint8_t)address;
+                    EECON1bits.CFGS  = 0;
+                    EECON1bits.EEPGD = 1;
+                    for(i = 0; i < BOOT_ROW_WORDS; i++)
+                    {
+                        EECON1bits.RD = 1;
+                        asm("nop");
+                        asm("nop");
+                        word = ((uint16_t)row[2 + (i << 1) + 1] << 8) | row[2 + (i << 1)];
+                        if(((EEDATH << 8) | EEDATL) != (word & BOOT_ERASED_WORD))
+                        {
+                            result = (pass == 0) ? BOOT_WRITTEN : BOOT_NAK_VERIFY;
+                            break;
+                        }
+                        EEADRL++;
+                    }
+                    if((pass != 0) || (result == BOOT_SKIPPED))
+                    {
+                        break;
+                    }
+
+                    /* Before the 1st change, row 0 is made the jump to here */
+                    target = ((stub_written == 0) && (address != 0)) ? 0 : address;
+                    while(1)
+                    {
+                        /* Erase Row */
+                        EEADRH = (uint8_t)(target >> 8);
+                        EEADRL = (uint8_t)target;
+                        EECON1bits.CFGS  = 0;
+                        EECON1bits.EEPGD = 1;
+                        EECON1bits.FREE  = 1;
+                        EECON1bits.WREN  = 1;
+                        BOOT_FLASH_UNLOCK();
+
+                        /* Load Latches, last word starts the write */
+                        EECON1bits.FREE = 0;
+                        EECON1bits.LWLO = 1;
+                        for(i = 0; i < BOOT_ROW_WORDS; i++)
+                        {
+                            if(target != address)
+                            {
+                                word = (i == 0) ? BOOT_STUB_MOVLP : ((i == 1) ? BOOT_STUB_GOTO : BOOT_ERASED_WORD);
+                            }
+                            else
+                            {
+                                word = ((uint16_t)row[2 + (i << 1) + 1] << 8) | row[2 + (i << 1)];
+                            }
+                            EEDATH = (uint8_t)(word >> 8);
+                            EEDATL = (uint8_t)word;
+                            if(i == (BOOT_ROW_WORDS - 1))
+                            {
+                                EECON1bits.LWLO = 0;
+                            }
+                            BOOT_FLASH_UNLOCK();
+                            EEADRL++;
+                        }
+                        EECON1bits.WREN = 0;
+
+                        if(target == address)
+                        {
+                            break;
+                        }
+                        target = address;
+                    }
+
+                    /* Real row 0 is written last, application is complete */
+                    stub_written = (address != 0);
+                }
+                BOOT_PUT(result);
+                break;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef _BOOTLOADER_H
+#define _BOOTLOADER_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+#include "pic_clock.h"
+#include "protocol.h"
+
+
+/* Program Memory (word address) */
+/*---------------------------------------------------
+| 0x0000 - 0x3BFF | Application (rows of 32 words)  |
+-----------------------------------------------------
+| 0x3C00 - 0x3FFF | Boot Loader (never written)     |
+-----------------------------------------------------
+ The range is reserved from the linker, only
+ boot_main() (absolute) is placed there. XC8 option:
+     --rom=default,-3c00-3fff
+ The image for boot_send is the output without the
+ range (byte address 0x7800 and above):
+     hexmate intercom.hex,0-77FF -Oupdate.hex
+---------------------------------------------------*/
+#define BOOT_FLASH_WORDS    (0x4000)
+#define BOOT_ROW_BYTES      (2 + (BOOT_ROW_WORDS * 2) + 2)  // Address, Words, CRC
+#define BOOT_MAX_BAUD       (BOOT_BAUD_115200)
+
+
+/* Jump to Boot Loader, written to row 0 during update */
+/*---------------------------------------------------
+| 0x0000 | MOVLP high(BOOT_ADDRESS)                 |
+| 0x0001 | GOTO  BOOT_ADDRESS                       |
+---------------------------------------------------*/
+#define BOOT_STUB_MOVLP     (0x3180 | (BOOT_ADDRESS >> 8))
+#define BOOT_STUB_GOTO      (0x2800 | (BOOT_ADDRESS & 0x07FF))
+#define BOOT_ERASED_WORD    (0x3FFF)
+
+
+/* Baudrate Generator at CLOCK_FREQ_FAST (BRGH = 1, BRG16 = 1, rounded) */
+#define BOOT_SPBRG(baud)    ((uint16_t)(((CLOCK_FREQ_FAST + ((baud) * 2)) / ((baud) * 4)) - 1))
+
+
+/* Receive Timeout before any row is changed (about 1s at FAST) */
+#define BOOT_TIMEOUT        (200000UL)
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Boot Loader
+ * @param
+ *     none:
+ * @return
+ *     none: (never returns, ends with reset)
+ * @note
+ *  Placed at BOOT_ADDRESS and self-contained: it calls
+ *  no other function and uses no const table, because
+ *  any other code may be rewritten while it runs.
+ *  Entered by PROTOCOL_BOOT + key (protocol.h), or
+ *  from reset while row 0 holds the jump (an update
+ *  was not finished).
+ *  Without any changed row, it returns to the
+ *  application after BOOT_TIMEOUT of silence.
+ *===================================================*/
+void boot_main(void);
+
+
+#endif  /* _BOOTLOADER_H */
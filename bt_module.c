@@ -0,0 +1,465 @@
+#include <xc.h>
+#include "bt_module.h"
+#include "systick.h"
+#include "timer_wheel.h"
+
+#if BT_ENABLE
+
+
+/* Engine State */
+/*---------------------------------------------------
+| State | Leaves when                               |
+-----------------------------------------------------
+| IDLE  | Command is queued -> KEY high             |
+-----------------------------------------------------
+| ENTER | TIMER_BT (BT_KEY_MS)                      |
+-----------------------------------------------------
+| SEND  | Whole command is in the transmitter       |
+-----------------------------------------------------
+| REPLY | OK / ERROR line or TIMER_BT               |
+---------------------------------------------------*/
+typedef enum
+{
+    BT_IDLE,
+    BT_ENTER,
+    BT_SEND,
+    BT_REPLY,
+} bt_state_t;
+
+
+/* Prototype of Static Function */
+static void command_done(uint8_t success);
+static void state_task(void);
+static uint8_t reply_matches(const char *p_value);
+
+
+/* Command Text (same order as bt_cmd_t) */
+static const char * const bt_cmd_text[BT_CMD_NUM] =
+{
+    "AT\r\n",
+    "AT+NAME?\r\n",
+    "AT+PSWD?\r\n",
+    "AT+UART?\r\n",
+    "AT+NAME=" BT_NAME "\r\n",
+    "AT+PSWD=" BT_PIN "\r\n",
+    "AT+UART=" BT_UART "\r\n",
+    "AT+RESET\r\n",
+};
+
+/* Setting expected in the reply of a query (index : query - BT_CMD_NAME_QUERY) */
+static const char * const bt_query_value[BT_CMD_QUERY_NUM] =
+{
+    BT_NAME,
+    BT_PIN,
+    BT_UART,
+};
+
+
+/* Command Queue */
+static bt_cmd_t queue[BT_QUEUE_SIZE];
+static uint8_t  queue_head;
+static uint8_t  queue_count;
+
+/* Engine */
+static bt_state_t  state;
+static const char *p_tx;        // Next character of the command
+static char        line[BT_LINE_SIZE];
+static uint8_t     line_len;
+static uint8_t     retry;
+static uint8_t     errors;
+static uint8_t     query_match; // Reply of the query is the setting
+
+/* Link */
+#if BT_STATE_PIN
+static uint8_t    link_up;
+static uint8_t    state_pin;    // Last sample of STATE
+static uint32_t   state_tick;   // STATE changed
+#endif
+static bt_event_t event;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Bluetooth Module Manager
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Name, PIN and Baudrate queries are queued, and
+ *     are sent by bt_task(). Call after timer_init()
+ *===================================================*/
+void bt_init(void)
+{
+    ANSELAbits.ANSA2 = 0;
+    BT_KEY      = 0;
+    BT_KEY_IO   = 0;
+#if BT_STATE_PIN
+    ANSELAbits.ANSA3 = 0;
+    BT_STATE_IO = 1;
+#endif
+
+    queue_head  = 0;
+    queue_count = 0;
+    state       = BT_IDLE;
+    errors      = 0;
+
+#if BT_STATE_PIN
+    link_up    = 0;
+    state_pin  = 0;
+    state_tick = systick_get();
+#endif
+    event      = BT_EVENT_NONE;
+
+    /* Check at every boot, module may have been replaced */
+    bt_queue(BT_CMD_PROBE);
+    bt_queue(BT_CMD_NAME_QUERY);
+    bt_queue(BT_CMD_PIN_QUERY);
+    bt_queue(BT_CMD_BAUD_QUERY);
+    bt_queue(BT_CMD_RESET);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Queue AT Command
+ * @param
+ *     cmd:command to send
+ * @return
+ *     1:Queued, 0:Queue is full
+ * @note
+ *     Does not wait, sent by bt_task()
+ *===================================================*/
+uint8_t bt_queue(bt_cmd_t cmd)
+{
+    if(queue_count >= BT_QUEUE_SIZE)
+    {
+        return 0;
+    }
+
+    queue[(queue_head + queue_count) & (BT_QUEUE_SIZE - 1)] = cmd;
+    queue_count++;
+
+    return 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Bluetooth Module Task
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from main loop, never waits. Sends
+ *     queued commands, checks the replies and follows
+ *     the STATE pin (BT_STATE_PIN)
+ *===================================================*/
+void bt_task(void)
+{
+#if BT_STATE_PIN
+    uint8_t pin = BT_STATE;
+    uint32_t now = systick_get();
+
+    /* STATE pin must be stable for BT_STATE_MS */
+    if(pin != state_pin)
+    {
+        state_pin  = pin;
+        state_tick = now;
+    }
+    else if((pin != link_up) && ((now - state_tick) >= SYSTICK_MS(BT_STATE_MS)))
+    {
+        link_up = pin;
+        if(link_up)
+        {
+            event = BT_EVENT_LINK_UP;
+            timer_stop(TIMER_BT_RELINK);
+        }
+        else
+        {
+            event = BT_EVENT_LINK_DOWN;
+            timer_start(TIMER_BT_RELINK, TIMER_TICKS(BT_RELINK_MS));
+        }
+    }
+
+    /* Handset did not come back, restart the module */
+    if(timer_expired(TIMER_BT_RELINK))
+    {
+        if(bt_queue(BT_CMD_PROBE))
+        {
+            bt_queue(BT_CMD_RESET);
+        }
+        timer_start(TIMER_BT_RELINK, TIMER_TICKS(BT_RELINK_MS));
+    }
+#endif
+
+    state_task();
+}
+
+
+/*=====================================================
+ * @brief
+ *     Check AT Command Mode
+ * @param
+ *     none:
+ * @return
+ *     1:Received data belongs to bt_task(), 0:Data mode
+ * @note
+ *     none
+ *===================================================*/
+uint8_t bt_command_mode(void)
+{
+    return (state != BT_IDLE);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Check Link to Handset
+ * @param
+ *     none:
+ * @return
+ *     1:Link is up, 0:Link is down
+ * @note
+ *     Follows the STATE pin after BT_STATE_MS. Always
+ *     1 without BT_STATE_PIN (link.c decides)
+ *===================================================*/
+uint8_t bt_link_up(void)
+{
+#if BT_STATE_PIN
+    return link_up;
+#else
+    return 1;
+#endif
+}
+
+
+/*=====================================================
+ * @brief
+ *     Take Link Event
+ * @param
+ *     none:
+ * @return
+ *     event since the last call (only the latest)
+ * @note
+ *     none
+ *===================================================*/
+bt_event_t bt_get_event(void)
+{
+    bt_event_t ret = event;
+
+    event = BT_EVENT_NONE;
+    return ret;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get AT Command Error Count
+ * @param
+ *     none:
+ * @return
+ *     commands dropped after BT_RETRY (wraps at 255)
+ * @note
+ *     none
+ *===================================================*/
+uint8_t bt_get_errors(void)
+{
+    return errors;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Command Engine
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Only as many characters as the transmitter takes
+ *     without waiting are written in each call
+ *---------------------------------------------------*/
+static void state_task(void)
+{
+    uint8_t data;
+
+    switch(state)
+    {
+        case BT_IDLE:
+            if(queue_count != 0)
+            {
+                BT_KEY = 1;
+                retry  = 0;
+                timer_start(TIMER_BT, TIMER_TICKS(BT_KEY_MS));
+                state  = BT_ENTER;
+            }
+            break;
+
+        case BT_ENTER:
+            if(timer_expired(TIMER_BT))
+            {
+                usart_rx_flush();
+                p_tx        = bt_cmd_text[queue[queue_head]];
+                query_match = 0;
+                state       = BT_SEND;
+            }
+            break;
+
+        case BT_SEND:
+            while((*p_tx != '\0') && PIR1bits.TXIF)
+            {
+                TXREG = *p_tx++;
+            }
+            if(*p_tx == '\0')
+            {
+                line_len = 0;
+                timer_start(TIMER_BT, TIMER_TICKS(BT_REPLY_MS));
+                state = BT_REPLY;
+            }
+            break;
+
+        case BT_REPLY:
+            while(usart_receive(&data))
+            {
+                if(data != '\n')
+                {
+                    if(line_len < BT_LINE_SIZE)
+                    {
+                        line[line_len++] = (char)data;
+                    }
+                    continue;
+                }
+
+                /* Lines other than OK / ERROR are information (reply of a query) */
+                if((line_len >= 1) && (line[0] == '+') &&
+                   (queue[queue_head] >= BT_CMD_NAME_QUERY) && (queue[queue_head] < BT_CMD_NAME))
+                {
+                    query_match = reply_matches(bt_query_value[queue[queue_head] - BT_CMD_NAME_QUERY]);
+                }
+                if((line_len >= 2) && (line[0] == 'O') && (line[1] == 'K'))
+                {
+                    command_done(1);
+                    return;
+                }
+                if((line_len >= 5) && (line[0] == 'E') && (line[1] == 'R'))
+                {
+                    command_done(0);
+                    return;
+                }
+                line_len = 0;
+            }
+            if(timer_expired(TIMER_BT))
+            {
+                command_done(0);
+            }
+            break;
+    }
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Finish Command
+ * @param
+ *     success:1:OK, 0:ERROR or no reply
+ * @return
+ *     none:
+ * @note
+ *     Failed command is sent again BT_RETRY times, then
+ *     dropped. A query which does not give the setting
+ *     is replaced by its write command. KEY is released
+ *     with the empty queue
+ *---------------------------------------------------*/
+static void command_done(uint8_t success)
+{
+    timer_stop(TIMER_BT);
+
+    if((success == 0) && (retry < BT_RETRY))
+    {
+        retry++;
+        usart_rx_flush();
+        p_tx        = bt_cmd_text[queue[queue_head]];
+        query_match = 0;
+        state       = BT_SEND;
+        return;
+    }
+
+    /* Setting differs (or cannot be read) : write it */
+    if((queue[queue_head] >= BT_CMD_NAME_QUERY) && (queue[queue_head] < BT_CMD_NAME) &&
+       ((success == 0) || (query_match == 0)))
+    {
+        queue[queue_head] = (bt_cmd_t)(queue[queue_head] + BT_CMD_QUERY_NUM);
+        retry = 0;
+        usart_rx_flush();
+        p_tx        = bt_cmd_text[queue[queue_head]];
+        query_match = 0;
+        state       = BT_SEND;
+        return;
+    }
+    if(success == 0)
+    {
+        errors++;
+    }
+
+    queue_head = (queue_head + 1) & (BT_QUEUE_SIZE - 1);
+    queue_count--;
+    retry = 0;
+
+    if(queue_count != 0)
+    {
+        p_tx        = bt_cmd_text[queue[queue_head]];
+        query_match = 0;
+        state       = BT_SEND;
+    }
+    else
+    {
+        BT_KEY = 0;
+        state  = BT_IDLE;
+    }
+}
+
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Compare Reply of a Query with the Setting
+ * @param
+ *     p_value:setting (BT_NAME, BT_PIN, BT_UART)
+ * @return
+ *     1:Same, 0:Differs
+ * @note
+ *     Reply line is "+NAME:value\r". Quotes around the
+ *     value (some firmware) are ignored
+ *---------------------------------------------------*/
+static uint8_t reply_matches(const char *p_value)
+{
+    uint8_t i = 0;
+
+    /* Value starts after ':' */
+    while((i < line_len) && (line[i] != ':'))
+    {
+        i++;
+    }
+    i++;
+
+    for(; i < line_len; i++)
+    {
+        if((line[i] == '"') || (line[i] == '\r'))
+        {
+            continue;
+        }
+        if(*p_value != line[i])
+        {
+            return 0;
+        }
+        p_value++;
+    }
+
+    /* Line longer than BT_LINE_SIZE is not a match */
+    return (uint8_t)((*p_value == '\0') && (line_len < BT_LINE_SIZE));
+}
+
+
+#endif  /* BT_ENABLE */
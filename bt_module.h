@@ -0,0 +1,208 @@
+#ifndef _BT_MODULE_H
+#define _BT_MODULE_H
+
+#include <xc.h>
+#include <stdint.h>
+#include "usart.h"
+
+
+/* Bluetooth Module (HC-05 type) is used on Point to Point link only */
+#if USART_MULTIDROP
+#define BT_ENABLE   (0)
+#else
+#define BT_ENABLE   (1)
+#endif
+
+
+/* Link State Source (can be overridden by compiler option -DBT_STATE_PIN=0) */
+/*---------------------------------------------------
+| 1 | STATE pin of the module (RA3) and heartbeat   |
+-----------------------------------------------------
+| 0 | Heartbeat only (link.c), module without STATE |
+|   | or not wired : RA3 is left free               |
+---------------------------------------------------*/
+#ifndef BT_STATE_PIN
+#define BT_STATE_PIN (1)
+#endif
+
+
+/* Pin Configuration */
+#define BT_KEY      RA2                 // High : AT command mode
+#define BT_KEY_IO   TRISAbits.TRISA2
+#define BT_STATE    RA3                 // High : Link is up
+#define BT_STATE_IO TRISAbits.TRISA3
+
+
+/* Module Setting (queried at boot, written only if it differs) */
+#define BT_NAME     "INTERCOM"
+#define BT_PIN      "1234"
+#define BT_UART     "9600,0,0"          // BAUDRATE, 1 stop bit, no parity
+
+
+/* AT Command (same order as bt_cmd_text[] of bt_module.c) */
+/*---------------------------------------------------
+ A query whose reply differs from the setting (or is
+ not answered) is replaced by its write command, so
+ the flash of the module is written only on a change.
+---------------------------------------------------*/
+typedef enum
+{
+    BT_CMD_PROBE,       // AT
+    BT_CMD_NAME_QUERY,  // AT+NAME?
+    BT_CMD_PIN_QUERY,   // AT+PSWD?
+    BT_CMD_BAUD_QUERY,  // AT+UART?
+    BT_CMD_NAME,        // AT+NAME=BT_NAME
+    BT_CMD_PIN,         // AT+PSWD=BT_PIN
+    BT_CMD_BAUD,        // AT+UART=BT_UART
+    BT_CMD_RESET,       // AT+RESET (back to data mode)
+    BT_CMD_NUM,
+} bt_cmd_t;
+
+#define BT_CMD_QUERY_NUM    (BT_CMD_NAME - BT_CMD_NAME_QUERY)
+
+
+/* Link Event */
+typedef enum
+{
+    BT_EVENT_NONE,
+    BT_EVENT_LINK_UP,
+    BT_EVENT_LINK_DOWN,
+} bt_event_t;
+
+
+/* Timing */
+/*---------------------------------------------------
+| Step              | Time                          |
+-----------------------------------------------------
+| KEY high -> AT    | BT_KEY_MS                     |
+-----------------------------------------------------
+| Command -> OK     | BT_REPLY_MS x (BT_RETRY + 1)  |
+-----------------------------------------------------
+| STATE change      | stable for BT_STATE_MS        |
+-----------------------------------------------------
+| Link down -> reset| BT_RELINK_MS                  |
+-----------------------------------------------------
+ Recovery after a handset drops out takes at most
+ BT_RELINK_MS + BT_KEY_MS + 2 commands, about 7s,
+ and is repeated every BT_RELINK_MS until the link
+ is up. The call path never waits for it. Without
+ BT_STATE_PIN the module reconnects by itself and
+ only the heartbeat of link.c finds the drop.
+---------------------------------------------------*/
+#define BT_KEY_MS       (100)
+#define BT_REPLY_MS     (500)
+#define BT_RETRY        (1)
+#define BT_STATE_MS     (50)
+#define BT_RELINK_MS    (5000)
+
+
+/* Command Queue Size */
+#define BT_QUEUE_SIZE   (8)     // Power of 2
+#define BT_LINE_SIZE    (16)    // Reply line, longer part is ignored
+
+
+#if BT_ENABLE
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Bluetooth Module Manager
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Name, PIN and Baudrate queries are queued, and
+ *     are sent by bt_task(). Call after timer_init()
+ *===================================================*/
+void bt_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Queue AT Command
+ * @param
+ *     cmd:command to send
+ * @return
+ *     1:Queued, 0:Queue is full
+ * @note
+ *     Does not wait, sent by bt_task()
+ *===================================================*/
+uint8_t bt_queue(bt_cmd_t cmd);
+
+
+/*=====================================================
+ * @brief
+ *     Bluetooth Module Task
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from main loop, never waits. Sends
+ *     queued commands, checks the replies and follows
+ *     the STATE pin (BT_STATE_PIN)
+ *===================================================*/
+void bt_task(void);
+
+
+/*=====================================================
+ * @brief
+ *     Check AT Command Mode
+ * @param
+ *     none:
+ * @return
+ *     1:Received data belongs to bt_task(), 0:Data mode
+ * @note
+ *     none
+ *===================================================*/
+uint8_t bt_command_mode(void);
+
+
+/*=====================================================
+ * @brief
+ *     Check Link to Handset
+ * @param
+ *     none:
+ * @return
+ *     1:Link is up, 0:Link is down
+ * @note
+ *     Follows the STATE pin after BT_STATE_MS. Always
+ *     1 without BT_STATE_PIN (link.c decides)
+ *===================================================*/
+uint8_t bt_link_up(void);
+
+
+/*=====================================================
+ * @brief
+ *     Take Link Event
+ * @param
+ *     none:
+ * @return
+ *     event since the last call (only the latest)
+ * @note
+ *     none
+ *===================================================*/
+bt_event_t bt_get_event(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get AT Command Error Count
+ * @param
+ *     none:
+ * @return
+ *     commands dropped after BT_RETRY (wraps at 255)
+ * @note
+ *     none
+ *===================================================*/
+uint8_t bt_get_errors(void);
+#else
+#define bt_init()
+#define bt_task()
+#define bt_command_mode()   (0)
+#define bt_link_up()        (1)
+#define bt_get_event()      (BT_EVENT_NONE)
+#endif
+
+
+#endif  /* _BT_MODULE_H */
@@ -1,5 +1,7 @@
 #include <xc.h>
 #include "button_interrupt.h"
+#include "call_manager.h"
+#include "latency.h"
 
 
 /*=====================================================
@@ -34,5 +36,23 @@ void button_interrupt_init(void)
 }
 
 
+/*=====================================================
+ * @brief
+ *     Button Interrupt
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called by irq_dispatch() when IOCBF0 is set.
+ *     Press is queued by call_press()
+ *===================================================*/
+void button_isr(void)
+{
+    call_press(0);
+    latency_edge();
 
-
+    /* Clear Flag */
+    IOCBF            = 0x00;
+    INTCONbits.IOCIF = 0;
+}
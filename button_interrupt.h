@@ -17,5 +17,19 @@
 void button_interrupt_init(void);
 
 
+/*=====================================================
+ * @brief
+ *     Button Interrupt
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called by irq_dispatch() when IOCBF0 is set.
+ *     Press is queued by call_press()
+ *===================================================*/
+void button_isr(void);
+
+
 #endif	/* BUTTON_INTERRUPT_H */
 
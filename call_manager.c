@@ -0,0 +1,214 @@
+#include <xc.h>
+#include "call_manager.h"
+
+
+/* Call in the Queue */
+typedef struct
+{
+    uint8_t  button;
+    uint8_t  presses;
+    uint8_t  reported;      // Press count sent to Handset
+    uint32_t last_tick;     // Last counted press
+} call_entry_t;
+
+
+/* Queue (changed by call_press() in isr) */
+static volatile call_entry_t queue[CALL_QUEUE_NUM];
+static volatile uint8_t queue_head;
+static volatile uint8_t queue_count;
+static volatile uint8_t dropped;
+static uint8_t active;          // Head is the active call
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Call Manager
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void call_init(void)
+{
+    queue_head  = 0;
+    queue_count = 0;
+    dropped     = 0;
+    active      = 0;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Record Button Press
+ * @param
+ *     button:pressed button (0 - CALL_BUTTON_NUM - 1)
+ * @return
+ *     none:
+ * @note
+ *     Called from isr()
+ *===================================================*/
+void call_press(uint8_t button)
+{
+    volatile call_entry_t *p_entry;
+    uint32_t now = systick_get();
+    uint32_t elapsed;
+    uint8_t i;
+
+    /* Merge into the call of the same Button */
+    for(i = 0; i < queue_count; i++)
+    {
+        p_entry = &queue[(queue_head + i) & (CALL_QUEUE_NUM - 1)];
+        if(p_entry->button != button)
+        {
+            continue;
+        }
+
+        elapsed = now - p_entry->last_tick;
+        if(elapsed < SYSTICK_MS(CALL_BOUNCE_MS))
+        {
+            return;
+        }
+        if(elapsed < SYSTICK_MS(CALL_COALESCE_MS))
+        {
+            if(p_entry->presses < CALL_PRESS_MAX)
+            {
+                p_entry->presses++;
+            }
+            p_entry->last_tick = now;
+            return;
+        }
+    }
+
+    /* New call */
+    if(queue_count >= CALL_QUEUE_NUM)
+    {
+        dropped++;
+        return;
+    }
+    p_entry = &queue[(queue_head + queue_count) & (CALL_QUEUE_NUM - 1)];
+    p_entry->button    = button;
+    p_entry->presses   = 1;
+    p_entry->reported  = 1;
+    p_entry->last_tick = now;
+    queue_count++;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Start Call at the head of the Queue
+ * @param
+ *     p_button:pointer to store button of the call
+ * @return
+ *     1:Call started, 0:Queue is empty
+ * @note
+ *     The call stays active until call_finish()
+ *===================================================*/
+uint8_t call_start(uint8_t *p_button)
+{
+    if((active != 0) || (queue_count == 0))
+    {
+        return 0;
+    }
+
+    /* Head is not moved by call_press() */
+    *p_button = queue[queue_head].button;
+    active    = 1;
+
+    return 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Take Press Count of the Active Call
+ * @param
+ *     p_presses:pointer to store the press count
+ * @return
+ *     1:Changed since the last call, 0:Not changed
+ * @note
+ *     The first press is reported by call_start()
+ *===================================================*/
+uint8_t call_take_update(uint8_t *p_presses)
+{
+    uint8_t presses;
+
+    if(active == 0)
+    {
+        return 0;
+    }
+
+    presses = queue[queue_head].presses;
+    if(presses == queue[queue_head].reported)
+    {
+        return 0;
+    }
+    queue[queue_head].reported = presses;
+    *p_presses = presses;
+
+    return 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Finish the Active Call
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Later presses of the button make a new call
+ *===================================================*/
+void call_finish(void)
+{
+    uint8_t iocie;
+
+    if(active == 0)
+    {
+        return;
+    }
+
+    iocie = INTCONbits.IOCIE;
+    INTCONbits.IOCIE = 0;
+
+    queue_head = (queue_head + 1) & (CALL_QUEUE_NUM - 1);
+    queue_count--;
+
+    INTCONbits.IOCIE = iocie;
+    active = 0;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Check Waiting Calls
+ * @param
+ *     none:
+ * @return
+ *     number of calls waiting behind the active call
+ * @note
+ *     none
+ *===================================================*/
+uint8_t call_pending(void)
+{
+    return (uint8_t)(queue_count - active);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Dropped Press Count
+ * @param
+ *     none:
+ * @return
+ *     presses lost with the full queue (wraps at 255)
+ * @note
+ *     none
+ *===================================================*/
+uint8_t call_get_dropped(void)
+{
+    return dropped;
+}
@@ -0,0 +1,134 @@
+#ifndef _CALL_MANAGER_H
+#define _CALL_MANAGER_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+#include "systick.h"
+
+
+/* Button */
+#define CALL_BUTTON_NUM     (1)     // RB0 (RB1 - RB7 are used by the display)
+
+
+/* Pending Call Queue */
+/*---------------------------------------------------
+| Press of a Button which ...        | is           |
+-----------------------------------------------------
+| has a call in the queue (active or | merged, the  |
+| waiting), pressed again within     | press count  |
+| CALL_COALESCE_MS of its last press | is increased |
+-----------------------------------------------------
+| closer than CALL_BOUNCE_MS to the  | ignored      |
+| last press (chattering)            |              |
+-----------------------------------------------------
+| other                              | queued as a  |
+|                                    | new call     |
+-----------------------------------------------------
+ The head of the queue is the active call. A full
+ queue drops the press (counted).
+---------------------------------------------------*/
+#define CALL_QUEUE_NUM      (4)     // Power of 2
+#define CALL_COALESCE_MS    (10000)
+#define CALL_BOUNCE_MS      (150)
+#define CALL_PRESS_MAX      (0xFF)
+
+
+/* Press count of the active call is sent at most every CALL_UPDATE_MS */
+#define CALL_UPDATE_MS      (1000)
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Call Manager
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void call_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Record Button Press
+ * @param
+ *     button:pressed button (0 - CALL_BUTTON_NUM - 1)
+ * @return
+ *     none:
+ * @note
+ *     Called from isr()
+ *===================================================*/
+void call_press(uint8_t button);
+
+
+/*=====================================================
+ * @brief
+ *     Start Call at the head of the Queue
+ * @param
+ *     p_button:pointer to store button of the call
+ * @return
+ *     1:Call started, 0:Queue is empty
+ * @note
+ *     The call stays active until call_finish()
+ *===================================================*/
+uint8_t call_start(uint8_t *p_button);
+
+
+/*=====================================================
+ * @brief
+ *     Take Press Count of the Active Call
+ * @param
+ *     p_presses:pointer to store the press count
+ * @return
+ *     1:Changed since the last call, 0:Not changed
+ * @note
+ *     The first press is reported by call_start()
+ *===================================================*/
+uint8_t call_take_update(uint8_t *p_presses);
+
+
+/*=====================================================
+ * @brief
+ *     Finish the Active Call
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Later presses of the button make a new call
+ *===================================================*/
+void call_finish(void);
+
+
+/*=====================================================
+ * @brief
+ *     Check Waiting Calls
+ * @param
+ *     none:
+ * @return
+ *     number of calls waiting behind the active call
+ * @note
+ *     none
+ *===================================================*/
+uint8_t call_pending(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get Dropped Press Count
+ * @param
+ *     none:
+ * @return
+ *     presses lost with the full queue (wraps at 255)
+ * @note
+ *     none
+ *===================================================*/
+uint8_t call_get_dropped(void);
+
+
+#endif  /* _CALL_MANAGER_H */
@@ -0,0 +1,286 @@
+#include <xc.h>
+#include "chime.h"
+#include "systick.h"
+
+
+/* Note */
+typedef enum
+{
+    NOTE_C5,
+    NOTE_E5,
+    NOTE_G5,
+    NOTE_C6,
+    NOTE_E6,
+    NOTE_G6,
+    NOTE_C7,
+    NOTE_REST,
+} note_t;
+
+
+/* Step of Melody (ticks = 0 : end) */
+typedef struct
+{
+    uint8_t note;
+    uint8_t ticks;      // [SYSTICK_PERIOD_MS]
+} chime_step_t;
+
+
+/* Prototype of Static Function */
+static void load_note(void);
+static void set_duty(void);
+
+
+/* PR4 of each Note [clock mode] (same order as note_t) */
+#define NOTE(freq)  { CHIME_PR4(freq, CLOCK_FREQ_IDLE, CHIME_PRESCALE_IDLE), \
+                      CHIME_PR4(freq, CLOCK_FREQ_FULL, CHIME_PRESCALE_FULL), \
+                      CHIME_PR4(freq, CLOCK_FREQ_FAST, CHIME_PRESCALE_FAST) }
+
+static const uint8_t note_pr4[NOTE_REST][3] =
+{
+    NOTE(523),      // C5
+    NOTE(659),      // E5
+    NOTE(784),      // G5
+    NOTE(1047),     // C6
+    NOTE(1319),     // E6
+    NOTE(1568),     // G6
+    NOTE(2093),     // C7
+};
+
+
+/* Melody */
+static const chime_step_t melody_press[] =
+{
+    {NOTE_E6,   SYSTICK_MS(400)},
+    {NOTE_C6,   SYSTICK_MS(600)},
+    {NOTE_REST, 0},
+};
+
+static const chime_step_t melody_responce[] =
+{
+    {NOTE_G5,   SYSTICK_MS(120)},
+    {NOTE_C6,   SYSTICK_MS(120)},
+    {NOTE_E6,   SYSTICK_MS(300)},
+    {NOTE_REST, 0},
+};
+
+static const chime_step_t melody_not_here[] =
+{
+    {NOTE_G5,   SYSTICK_MS(200)},
+    {NOTE_REST, SYSTICK_MS(100)},
+    {NOTE_C5,   SYSTICK_MS(400)},
+    {NOTE_REST, 0},
+};
+
+static const chime_step_t * const melody_table[CHIME_MELODY_NUM] =
+{
+    melody_press,
+    melody_responce,
+    melody_not_here,
+};
+
+
+/* Player (changed by chime_tick()) */
+static const chime_step_t * volatile p_step;    // NULL : silent
+static volatile uint8_t note_left;              // Ticks left of the note
+static volatile uint8_t note_age;               // Ticks since the note started
+static uint8_t duty_full;                       // CCPR1L of 50% duty
+static uint8_t mode_index;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Chime (CCP1 PWM, Timer4)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     RC2 (CCP1) is the output
+ *===================================================*/
+void chime_init(void)
+{
+    p_step = 0;
+
+    /* Output stays low while silent */
+    CCPR1L       = 0;
+    CCP1CON      = CCP1CON_PWM;
+    CCPTMRS0     = CCPTMRS0_C1_TMR4;
+    CHIME_OUT_IO = 0;
+
+    chime_set_mode(clock_get_mode());
+}
+
+
+/*=====================================================
+ * @brief
+ *     Start Melody
+ * @param
+ *     melody:melody to play
+ * @return
+ *     none:
+ * @note
+ *     Does not wait, notes are changed by chime_tick().
+ *     Melody in play is stopped
+ *===================================================*/
+void chime_play(chime_melody_t melody)
+{
+    uint8_t tmr2ie;
+
+    tmr2ie = PIE1bits.TMR2IE;
+    PIE1bits.TMR2IE = 0;
+
+    p_step = melody_table[melody];
+    load_note();
+
+    PIE1bits.TMR2IE = tmr2ie;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Stop Melody
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void chime_stop(void)
+{
+    uint8_t tmr2ie;
+
+    tmr2ie = PIE1bits.TMR2IE;
+    PIE1bits.TMR2IE = 0;
+
+    p_step = 0;
+    CCPR1L = 0;
+
+    PIE1bits.TMR2IE = tmr2ie;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Set Timer4 for Clock Mode
+ * @param
+ *     mode:current clock mode
+ * @return
+ *     none:
+ * @note
+ *     Called by clock_set_mode(), keeps the pitch
+ *===================================================*/
+void chime_set_mode(clock_mode_t mode)
+{
+    uint8_t tmr2ie;
+
+    tmr2ie = PIE1bits.TMR2IE;
+    PIE1bits.TMR2IE = 0;
+
+    mode_index = (uint8_t)mode;
+    switch(mode)
+    {
+        case CLOCK_MODE_IDLE:
+            T4CON = (T4CON_TMR4ON | T4CON_T4CKPS_1);
+            break;
+
+        default:
+            T4CON = (T4CON_TMR4ON | T4CON_T4CKPS_64);
+            break;
+    }
+
+    /* Reload the note in play */
+    if((p_step != 0) && (p_step->note != NOTE_REST))
+    {
+        PR4       = note_pr4[p_step->note][mode_index];
+        duty_full = (uint8_t)((PR4 + 1) / 2);
+        set_duty();
+    }
+
+    PIE1bits.TMR2IE = tmr2ie;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Advance Melody
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from systick_isr(). Only the duty is
+ *     updated unless a note ends
+ *===================================================*/
+void chime_tick(void)
+{
+    if(p_step == 0)
+    {
+        return;
+    }
+
+    note_age++;
+    if(--note_left != 0)
+    {
+        set_duty();
+        return;
+    }
+
+    /* Next note */
+    p_step++;
+    load_note();
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Start Note of p_step
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Melody ends at a step with 0 ticks
+ *---------------------------------------------------*/
+static void load_note(void)
+{
+    if(p_step->ticks == 0)
+    {
+        p_step = 0;
+        CCPR1L = 0;
+        return;
+    }
+
+    note_left = p_step->ticks;
+    note_age  = 0;
+
+    if(p_step->note == NOTE_REST)
+    {
+        duty_full = 0;
+    }
+    else
+    {
+        PR4       = note_pr4[p_step->note][mode_index];
+        duty_full = (uint8_t)((PR4 + 1) / 2);
+    }
+    set_duty();
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Set PWM Duty with Envelope
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Duty is halved every 2^CHIME_DECAY_SHIFT ticks,
+ *     which sounds like a struck bell
+ *---------------------------------------------------*/
+static void set_duty(void)
+{
+    uint8_t shift = note_age >> CHIME_DECAY_SHIFT;
+
+    CCPR1L = (shift < 8) ? (uint8_t)(duty_full >> shift) : 0;
+}
@@ -0,0 +1,125 @@
+#ifndef _CHIME_H
+#define _CHIME_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+#include "pic_clock.h"
+
+
+/* Speaker (piezo) on CCP1 */
+#define CHIME_OUT_IO    TRISCbits.TRISC2
+
+
+/* Melody */
+typedef enum
+{
+    CHIME_PRESS,        // Ding-dong at the door
+    CHIME_RESPONCE,     // Responce is displayed
+    CHIME_NOT_HERE,     // No Responce
+    CHIME_MELODY_NUM,
+} chime_melody_t;
+
+
+/* Timer4 Setting of each Clock Mode (PWM period = pitch) */
+/*---------------------------------------------------
+| Mode | Fosc/4 | Prescaler | PR4 (C5 - C7)         |
+-----------------------------------------------------
+| IDLE | 125kHz |   1:1     | 238 - 59              |
+-----------------------------------------------------
+| FULL | 2.5MHz |   1:64    |  74 - 18              |
+-----------------------------------------------------
+| FAST | 4MHz   |   1:64    | 119 - 29              |
+---------------------------------------------------*/
+#define CHIME_PRESCALE_IDLE (1)
+#define CHIME_PRESCALE_FULL (64)
+#define CHIME_PRESCALE_FAST (64)
+#define CHIME_PR4(freq, clock, prescale) \
+    ((uint8_t)(((((clock) / 4 / (prescale)) + ((freq) / 2)) / (freq)) - 1))
+
+
+/* T4CON Register Mask */
+#define T4CON_T4CKPS_1      (0b00 << 0)
+#define T4CON_T4CKPS_64     (0b11 << 0)
+#define T4CON_TMR4ON        (1 << 2)
+
+
+/* CCP1 Setting */
+#define CCP1CON_PWM         (0b1100 << 0)
+#define CCPTMRS0_C1_TMR4    (0b01 << 0)
+
+
+/* Envelope : volume (duty) is halved every 2^CHIME_DECAY_SHIFT ticks */
+#define CHIME_DECAY_SHIFT   (3)     // 80ms
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Chime (CCP1 PWM, Timer4)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     RC2 (CCP1) is the output
+ *===================================================*/
+void chime_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Start Melody
+ * @param
+ *     melody:melody to play
+ * @return
+ *     none:
+ * @note
+ *     Does not wait, notes are changed by chime_tick().
+ *     Melody in play is stopped
+ *===================================================*/
+void chime_play(chime_melody_t melody);
+
+
+/*=====================================================
+ * @brief
+ *     Stop Melody
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void chime_stop(void);
+
+
+/*=====================================================
+ * @brief
+ *     Set Timer4 for Clock Mode
+ * @param
+ *     mode:current clock mode
+ * @return
+ *     none:
+ * @note
+ *     Called by clock_set_mode(), keeps the pitch
+ *===================================================*/
+void chime_set_mode(clock_mode_t mode);
+
+
+/*=====================================================
+ * @brief
+ *     Advance Melody
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from systick_isr(). Only the duty is
+ *     updated unless a note ends
+ *===================================================*/
+void chime_tick(void);
+
+
+#endif  /* _CHIME_H */
@@ -0,0 +1,73 @@
+#include <xc.h>
+#include "eeprom.h"
+
+
+/*=====================================================
+ * @brief
+ *     Read 1 Byte from Data EEPROM
+ * @param
+ *     address:EEPROM address
+ * @return
+ *     read data
+ * @note
+ *     Must not be called while eeprom_busy()
+ *===================================================*/
+uint8_t eeprom_read(uint8_t address)
+{
+    EEADRL = address;
+    EECON1bits.CFGS  = 0;   // Not Configuration space
+    EECON1bits.EEPGD = 0;   // Data EEPROM
+    EECON1bits.RD    = 1;
+
+    return EEDATL;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Start writing 1 Byte to Data EEPROM
+ * @param
+ *     address:EEPROM address
+ *     data   :data to write
+ * @return
+ *     none:
+ * @note
+ *     Does not wait for completion (about 4ms).
+ *     Must not be called while eeprom_busy()
+ *===================================================*/
+void eeprom_write_start(uint8_t address, uint8_t data)
+{
+    uint8_t gie;
+
+    EEADRL = address;
+    EEDATL = data;
+    EECON1bits.CFGS  = 0;
+    EECON1bits.EEPGD = 0;
+    EECON1bits.WREN  = 1;
+
+    /* Required Sequence (No interrupt allowed) */
+    gie = INTCONbits.GIE;
+    INTCONbits.GIE = 0;
+    EECON2 = 0x55;
+    EECON2 = 0xAA;
+    EECON1bits.WR  = 1;
+    INTCONbits.GIE = gie;
+
+    EECON1bits.WREN = 0;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Check Data EEPROM Write in progress
+ * @param
+ *     none:
+ * @return
+ *     0:Ready, 1:Busy
+ * @note
+ *     none
+ *===================================================*/
+uint8_t eeprom_busy(void)
+{
+    return EECON1bits.WR;
+}
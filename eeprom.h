@@ -0,0 +1,74 @@
+#ifndef _EEPROM_H
+#define _EEPROM_H
+
+#include <xc.h>
+#include <stdint.h>
+
+
+/* Data EEPROM Size */
+#define EEPROM_SIZE (256)
+
+
+/* Data EEPROM Map */
+/*---------------------------------------------------
+| Address     | Contents                            |
+-----------------------------------------------------
+| 0x00 - 0xB9 | Call Journal (journal.c)            |
+-----------------------------------------------------
+| 0xBA - 0xBD | Reserved                            |
+-----------------------------------------------------
+| 0xBE        | Boot count (journal.c)              |
+-----------------------------------------------------
+| 0xBF        | Journal format (journal.c)          |
+-----------------------------------------------------
+| 0xC0        | Unit address (usart.c, Multi-drop)  |
+-----------------------------------------------------
+| 0xC1        | Language (language.c)               |
+-----------------------------------------------------
+| 0xC2 - 0xFF | Reserved                            |
+---------------------------------------------------*/
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Read 1 Byte from Data EEPROM
+ * @param
+ *     address:EEPROM address
+ * @return
+ *     read data
+ * @note
+ *     Must not be called while eeprom_busy()
+ *===================================================*/
+uint8_t eeprom_read(uint8_t address);
+
+
+/*=====================================================
+ * @brief
+ *     Start writing 1 Byte to Data EEPROM
+ * @param
+ *     address:EEPROM address
+ *     data   :data to write
+ * @return
+ *     none:
+ * @note
+ *     Does not wait for completion (about 4ms).
+ *     Must not be called while eeprom_busy()
+ *===================================================*/
+void eeprom_write_start(uint8_t address, uint8_t data);
+
+
+/*=====================================================
+ * @brief
+ *     Check Data EEPROM Write in progress
+ * @param
+ *     none:
+ * @return
+ *     0:Ready, 1:Busy
+ * @note
+ *     none
+ *===================================================*/
+uint8_t eeprom_busy(void);
+
+
+#endif  /* _EEPROM_H */
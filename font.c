@@ -0,0 +1,281 @@
+#include <xc.h>
+#include "font.h"
+#include "spi.h"
+#include "oled_bus.h"
+#include "oled_lcd_lib.h"
+
+
+/* Prototype of Static Function */
+static uint8_t lookup(uint16_t jis);
+static void stream_read(uint32_t address, uint8_t *p_buf, uint8_t len);
+static void stream_close(void);
+
+
+/* Glyph Cache */
+static uint8_t  cache_glyph[FONT_CACHE_NUM][FONT_GLYPH_BYTES];
+static uint16_t cache_jis[FONT_CACHE_NUM];     // 0 : empty
+static uint16_t cache_use[FONT_CACHE_NUM];     // use_clock of the last use
+static uint16_t use_clock;
+static font_stats_t stats;
+
+/* Font Flash */
+static uint8_t  font_available;
+static uint8_t  stream_open;                    // FONT_CS is low
+static uint32_t stream_address;                 // Next address of the stream
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Font
+ * @param
+ *     none:
+ * @return
+ *     1:Font image found, 0:No font flash
+ * @note
+ *     MSSP is initialized by spi_init()
+ *===================================================*/
+uint8_t font_init(void)
+{
+    uint8_t header[FONT_HEADER_BYTES];
+    uint8_t i;
+
+    FONT_CS    = 1;
+    FONT_CS_IO = 0;
+    spi_init();
+
+    for(i = 0; i < FONT_CACHE_NUM; i++)
+    {
+        cache_jis[i] = 0;
+        cache_use[i] = 0;
+    }
+    use_clock   = 0;
+    stats.hit   = 0;
+    stats.miss  = 0;
+    stream_open = 0;
+
+    /* Erased flash (0xFF) or no flash (0x00 / 0xFF) is not a font */
+    stream_read(FONT_BASE, header, FONT_HEADER_BYTES);
+    stream_close();
+    font_available = ((header[0] == 'J') && (header[1] == 'F') && (header[2] == FONT_GLYPH_BYTES));
+
+    return font_available;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Glyph
+ * @param
+ *     jis:JIS X 0208 code
+ * @return
+ *     pointer to FONT_GLYPH_BYTES columns
+ * @note
+ *     Read from the flash only on a cache miss.
+ *     Valid until FONT_CACHE_NUM other glyphs are used.
+ *     Codes out of range and a missing font are blank
+ *===================================================*/
+const uint8_t *font_glyph(uint16_t jis)
+{
+    uint8_t slot;
+
+    slot = lookup(jis);
+    stream_close();
+
+    return cache_glyph[slot];
+}
+
+
+/*=====================================================
+ * @brief
+ *     Write Text to LCD (Graphic mode)
+ * @param
+ *     x     :x address (0 - 99)
+ *     line  :y address (0 - 1)
+ *     p_text:JIS X 0208 codes
+ *     len   :number of characters (FONT_LINE_CHARS max)
+ * @return
+ *     none:
+ * @note
+ *     All glyphs are fetched before the display is
+ *     written, so that missed glyphs next to each
+ *     other in the flash are read in one stream.
+ *     Display is not cleared
+ *===================================================*/
+void font_write_text(uint8_t x, uint8_t line, const uint16_t *p_text, uint8_t len)
+{
+    uint8_t slot[FONT_LINE_CHARS];
+    uint8_t i;
+
+    if(len > FONT_LINE_CHARS)
+    {
+        len = FONT_LINE_CHARS;
+    }
+
+    /* Glyphs of this line are the newest, never replaced in this loop */
+    for(i = 0; i < len; i++)
+    {
+        slot[i] = lookup(p_text[i]);
+    }
+    stream_close();
+
+    /* Display shares MSSP, FONT_CS is high here */
+    lcd_write((uint8_t)(0b10000000 | x), WRITE_COMMAND_REG);
+    lcd_write((uint8_t)(0b01000000 | line), WRITE_COMMAND_REG);
+    for(i = 0; i < len; i++)
+    {
+        oled_bus_data(cache_glyph[slot[i]], FONT_GLYPH_BYTES);
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Cache Counters
+ * @param
+ *     none:
+ * @return
+ *     pointer to counters
+ * @note
+ *     Counters stop at 0xFFFF
+ *===================================================*/
+const font_stats_t *font_get_stats(void)
+{
+    return &stats;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Find Glyph in the Cache (or load it)
+ * @param
+ *     jis:JIS X 0208 code
+ * @return
+ *     cache slot
+ * @note
+ *     Stream may be left open for the next miss,
+ *     caller closes it by stream_close()
+ *---------------------------------------------------*/
+static uint8_t lookup(uint16_t jis)
+{
+    uint8_t  hi = (uint8_t)(jis >> 8);
+    uint8_t  lo = (uint8_t)jis;
+    uint8_t  slot;
+    uint8_t  i;
+    uint16_t age;
+    uint16_t index;
+
+    use_clock++;
+
+    for(i = 0; i < FONT_CACHE_NUM; i++)
+    {
+        if((cache_jis[i] == jis) && (jis != 0))
+        {
+            cache_use[i] = use_clock;
+            if(stats.hit < 0xFFFF)
+            {
+                stats.hit++;
+            }
+            return i;
+        }
+    }
+
+    /* Replace least recently used (empty slot is the oldest) */
+    slot = 0;
+    age  = 0;
+    for(i = 0; i < FONT_CACHE_NUM; i++)
+    {
+        if(cache_jis[i] == 0)
+        {
+            slot = i;
+            break;
+        }
+        if((uint16_t)(use_clock - cache_use[i]) > age)
+        {
+            age  = use_clock - cache_use[i];
+            slot = i;
+        }
+    }
+    if(stats.miss < 0xFFFF)
+    {
+        stats.miss++;
+    }
+
+    cache_jis[slot] = jis;
+    cache_use[slot] = use_clock;
+
+    if((font_available == 0) || (hi < FONT_JIS_MIN) || (hi > FONT_JIS_MAX) ||
+       (lo < FONT_JIS_MIN) || (lo > FONT_JIS_MAX))
+    {
+        for(i = 0; i < FONT_GLYPH_BYTES; i++)
+        {
+            cache_glyph[slot][i] = 0;
+        }
+        return slot;
+    }
+
+    index = (uint16_t)((hi - FONT_JIS_MIN) * 94 + (lo - FONT_JIS_MIN));
+    stream_read(FONT_BASE + FONT_HEADER_BYTES + ((uint32_t)index * FONT_GLYPH_BYTES),
+                cache_glyph[slot], FONT_GLYPH_BYTES);
+
+    return slot;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Read Font Flash
+ * @param
+ *     address:flash address
+ *     p_buf  :pointer to store data
+ *     len    :number of bytes
+ * @return
+ *     none:
+ * @note
+ *     Read command is sent only when the address does
+ *     not follow the open stream
+ *---------------------------------------------------*/
+static void stream_read(uint32_t address, uint8_t *p_buf, uint8_t len)
+{
+    if((stream_open == 0) || (address != stream_address))
+    {
+        stream_close();
+
+        spi_set_clock(SPI_CLOCK_FAST);
+        FONT_CS = 0;
+        spi_transfer(FLASH_CMD_READ);
+        spi_transfer((uint8_t)(address >> 16));
+        spi_transfer((uint8_t)(address >> 8));
+        spi_transfer((uint8_t)address);
+        stream_open = 1;
+    }
+
+    while(len-- != 0)
+    {
+        *p_buf++ = spi_transfer(0xFF);
+        address++;
+    }
+    stream_address = address;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     End Read Stream
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Clock is returned to SPI_CLOCK_SLOW for the display
+ *---------------------------------------------------*/
+static void stream_close(void)
+{
+    if(stream_open == 0)
+    {
+        return;
+    }
+
+    FONT_CS = 1;
+    spi_set_clock(SPI_CLOCK_SLOW);
+    stream_open = 0;
+}
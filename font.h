@@ -0,0 +1,115 @@
+#ifndef _FONT_H
+#define _FONT_H
+
+#include <xc.h>
+#include <stdint.h>
+
+
+/* Font Flash (25 series serial flash, 1Mbit or more) */
+#define FONT_CS         RA4     // Chip Select (Active Low)
+#define FONT_CS_IO      TRISAbits.TRISA4
+
+
+/* Serial Flash Command */
+#define FLASH_CMD_READ  (0x03)  // + address (24bit), then data is streamed
+
+
+/* Font Image (built by tools/font_pack.c) */
+/*---------------------------------------------------
+| Address             | Contents                    |
+-----------------------------------------------------
+| FONT_BASE + 0       | 'J', 'F', FONT_GLYPH_BYTES, |
+|                     | 0                           |
+-----------------------------------------------------
+| FONT_BASE + 4 + 8 i | Glyph of JIS X 0208 code    |
+|                     | i = (ku - 1) x 94 + ten - 1 |
+-----------------------------------------------------
+ A glyph is 8 columns of 8 dots, same as the data
+ of graphic mode (bit0 : top). Missing glyphs are 0.
+---------------------------------------------------*/
+#define FONT_BASE           (0x000000UL)
+#define FONT_HEADER_BYTES   (4)
+#define FONT_GLYPH_BYTES    (8)
+#define FONT_GLYPH_NUM      (94 * 94)
+
+
+/* JIS X 0208 Code (0x2121 - 0x7E7E) */
+#define FONT_JIS_MIN    (0x21)
+#define FONT_JIS_MAX    (0x7E)
+
+
+/* Glyph Cache (least recently used glyph is replaced) */
+#define FONT_CACHE_NUM  (16)    // 128 byte
+#define FONT_LINE_CHARS (12)    // 100 dots / 8, must be <= FONT_CACHE_NUM
+
+
+/* Cache Counters */
+typedef struct
+{
+    uint16_t hit;
+    uint16_t miss;
+} font_stats_t;
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Font
+ * @param
+ *     none:
+ * @return
+ *     1:Font image found, 0:No font flash
+ * @note
+ *     MSSP is initialized by spi_init()
+ *===================================================*/
+uint8_t font_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get Glyph
+ * @param
+ *     jis:JIS X 0208 code
+ * @return
+ *     pointer to FONT_GLYPH_BYTES columns
+ * @note
+ *     Read from the flash only on a cache miss.
+ *     Valid until FONT_CACHE_NUM other glyphs are used.
+ *     Codes out of range and a missing font are blank
+ *===================================================*/
+const uint8_t *font_glyph(uint16_t jis);
+
+
+/*=====================================================
+ * @brief
+ *     Write Text to LCD (Graphic mode)
+ * @param
+ *     x     :x address (0 - 99)
+ *     line  :y address (0 - 1)
+ *     p_text:JIS X 0208 codes
+ *     len   :number of characters (FONT_LINE_CHARS max)
+ * @return
+ *     none:
+ * @note
+ *     All glyphs are fetched before the display is
+ *     written, so that missed glyphs next to each
+ *     other in the flash are read in one stream.
+ *     Display is not cleared
+ *===================================================*/
+void font_write_text(uint8_t x, uint8_t line, const uint16_t *p_text, uint8_t len);
+
+
+/*=====================================================
+ * @brief
+ *     Get Cache Counters
+ * @param
+ *     none:
+ * @return
+ *     pointer to counters
+ * @note
+ *     Counters stop at 0xFFFF
+ *===================================================*/
+const font_stats_t *font_get_stats(void);
+
+
+#endif  /* _FONT_H */
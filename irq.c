@@ -0,0 +1,230 @@
+#include <xc.h>
+#include "irq.h"
+#include "usart.h"
+#include "systick.h"
+#include "button_interrupt.h"
+#include "perf.h"
+
+
+/* Source */
+typedef struct
+{
+    volatile uint8_t *p_enable;
+    uint8_t enable_mask;
+    volatile uint8_t *p_flag;
+    uint8_t flag_mask;
+    uint8_t clear_flag;         // 1:Flag is cleared before handler
+    void (*handler)(void);
+} irq_source_t;
+
+
+/* Prototype of Static Function */
+static void serve(uint8_t id);
+#if PERF_ENABLE
+static uint16_t stamp(void);
+#endif
+
+
+/* Source Table (same order as irq_source_id_t) */
+static const irq_source_t irq_source[IRQ_SOURCE_NUM] =
+{
+    /* RCIF is cleared by reading RCREG */
+    {&PIE1,   (1 << 5), &PIR1,  (1 << 5), 0, usart_rx_isr},
+    {&PIE1,   (1 << 1), &PIR1,  (1 << 1), 1, systick_isr},
+    /* IOCBF and IOCIF are cleared by handler */
+    {&INTCON, (1 << 3), &IOCBF, (1 << 0), 0, button_isr},
+#if PERF_ENABLE
+    {&PIE1,   (1 << 0), &PIR1,  (1 << 0), 1, perf_isr},
+#endif
+};
+
+
+#if PERF_ENABLE
+/* Source Name (same order as irq_source_id_t) */
+static const char * const irq_name[IRQ_SOURCE_NUM] =
+{
+    "usart_rx",
+    "systick",
+    "button",
+    "perf",
+};
+
+static irq_stats_t irq_stats[IRQ_SOURCE_NUM];
+static uint16_t entry_stamp;
+static uint16_t rx_wait_max;
+#endif
+
+
+/*=====================================================
+ * @brief
+ *     Serve Pending Interrupt Sources
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from isr()
+ *===================================================*/
+void irq_dispatch(void)
+{
+    uint8_t id;
+
+#if PERF_ENABLE
+    entry_stamp = stamp();
+#endif
+
+    for(id = 0; id < IRQ_SOURCE_NUM; id++)
+    {
+        serve(id);
+
+        /* Received byte waits for 1 handler at most */
+        if(id != IRQ_USART_RX)
+        {
+            serve(IRQ_USART_RX);
+        }
+    }
+}
+
+
+#if PERF_ENABLE
+/*=====================================================
+ * @brief
+ *     Get Statistics of Source
+ * @param
+ *     id:source
+ * @return
+ *     copy of the statistics
+ * @note
+ *     none
+ *===================================================*/
+irq_stats_t irq_get_stats(irq_source_id_t id)
+{
+    irq_stats_t stats;
+
+    di();
+    stats = irq_stats[id];
+    ei();
+
+    return stats;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Name of Source
+ * @param
+ *     id:source
+ * @return
+ *     name (for perf_dump())
+ * @note
+ *     none
+ *===================================================*/
+const char *irq_get_name(irq_source_id_t id)
+{
+    return irq_name[id];
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Worst Receive Latency
+ * @param
+ *     none:
+ * @return
+ *     cycles from entry of isr() to usart_rx_isr()
+ * @note
+ *     none
+ *===================================================*/
+uint16_t irq_get_rx_wait_max(void)
+{
+    uint16_t wait;
+
+    di();
+    wait = rx_wait_max;
+    ei();
+
+    return wait;
+}
+#endif
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Call Handler if the Source is Enabled and Pending
+ * @param
+ *     id:source
+ * @return
+ *     none:
+ * @note
+ *     none
+ *---------------------------------------------------*/
+static void serve(uint8_t id)
+{
+    const irq_source_t *p_source = &irq_source[id];
+#if PERF_ENABLE
+    irq_stats_t *p_stats = &irq_stats[id];
+    uint16_t start;
+    uint16_t cycle;
+#endif
+
+    if(((*p_source->p_enable & p_source->enable_mask) == 0) ||
+       ((*p_source->p_flag & p_source->flag_mask) == 0))
+    {
+        return;
+    }
+
+    if(p_source->clear_flag)
+    {
+        *p_source->p_flag &= (uint8_t)~p_source->flag_mask;
+    }
+
+#if PERF_ENABLE
+    start = stamp();
+    if((id == IRQ_USART_RX) && ((uint16_t)(start - entry_stamp) > rx_wait_max))
+    {
+        rx_wait_max = start - entry_stamp;
+    }
+#endif
+
+    p_source->handler();
+
+#if PERF_ENABLE
+    cycle = stamp() - start;
+    if(p_stats->count < 0xFFFF)
+    {
+        p_stats->count++;
+    }
+    if(cycle > p_stats->max)
+    {
+        p_stats->max = cycle;
+    }
+#endif
+}
+
+
+#if PERF_ENABLE
+/*-----------------------------------------------------
+ * @brief
+ *     Read Timer1 (lower 16bit of perf_now())
+ * @param
+ *     none:
+ * @return
+ *     cycle stamp
+ * @note
+ *     Differences are valid up to 65535 cycles
+ *---------------------------------------------------*/
+static uint16_t stamp(void)
+{
+    uint8_t high;
+    uint8_t low;
+
+    /* TMR1L may carry into TMR1H between the reads */
+    do
+    {
+        high = TMR1H;
+        low  = TMR1L;
+    } while(high != TMR1H);
+
+    return ((uint16_t)high << 8) | low;
+}
+#endif
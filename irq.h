@@ -0,0 +1,104 @@
+#ifndef _IRQ_H
+#define _IRQ_H
+
+#include <xc.h>
+#include <stdint.h>
+#include "perf.h"
+
+
+/* Interrupt Source (in order of priority) */
+/*---------------------------------------------------
+| Source   | Enable / Flag     | Handler            |
+-----------------------------------------------------
+| USART_RX | RCIE / RCIF       | usart_rx_isr()     |
+-----------------------------------------------------
+| SYSTICK  | TMR2IE / TMR2IF   | systick_isr()      |
+-----------------------------------------------------
+| BUTTON   | IOCIE / IOCBF0    | button_isr()       |
+-----------------------------------------------------
+| PERF     | TMR1IE / TMR1IF   | perf_isr()         |
+|          | (PERF_ENABLE = 1) |                    |
+-----------------------------------------------------
+ A source is served only if it is enabled, so that a
+ critical section masking 1 source (e.g. TMR2IE) is
+ not broken by another interrupt.
+ USART_RX is checked again after each other handler :
+ a received byte waits for 1 handler at most, however
+ many sources are added (RCREG holds 2 bytes).
+---------------------------------------------------*/
+typedef enum
+{
+    IRQ_USART_RX,
+    IRQ_SYSTICK,
+    IRQ_BUTTON,
+#if PERF_ENABLE
+    IRQ_PERF,
+#endif
+    IRQ_SOURCE_NUM,
+} irq_source_id_t;
+
+
+/* Statistics of Source (PERF_ENABLE = 1, Timer1 cycles) */
+typedef struct
+{
+    uint16_t count;             // Stops at 0xFFFF
+    uint16_t max;               // Longest handler
+} irq_stats_t;
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Serve Pending Interrupt Sources
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from isr()
+ *===================================================*/
+void irq_dispatch(void);
+
+
+#if PERF_ENABLE
+/*=====================================================
+ * @brief
+ *     Get Statistics of Source
+ * @param
+ *     id:source
+ * @return
+ *     copy of the statistics
+ * @note
+ *     none
+ *===================================================*/
+irq_stats_t irq_get_stats(irq_source_id_t id);
+
+
+/*=====================================================
+ * @brief
+ *     Get Name of Source
+ * @param
+ *     id:source
+ * @return
+ *     name (for perf_dump())
+ * @note
+ *     none
+ *===================================================*/
+const char *irq_get_name(irq_source_id_t id);
+
+
+/*=====================================================
+ * @brief
+ *     Get Worst Receive Latency
+ * @param
+ *     none:
+ * @return
+ *     cycles from entry of isr() to usart_rx_isr()
+ * @note
+ *     none
+ *===================================================*/
+uint16_t irq_get_rx_wait_max(void);
+#endif
+
+
+#endif  /* _IRQ_H */
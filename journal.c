@@ -0,0 +1,301 @@
+#include <xc.h>
+#include "journal.h"
+#include "eeprom.h"
+#include "systick.h"
+#include "usart.h"
+#include "protocol.h"
+#include "supervisor.h"
+
+
+/* Prototype of Static Function */
+static uint8_t slot_address(uint8_t slot);
+static uint8_t next_sequence(uint8_t seq);
+
+
+/* Byte order to write a record (Sequence number last) */
+static const uint8_t write_order[JOURNAL_RECORD_SIZE] = {1, 2, 3, 4, 5, 0};
+
+
+/* Journal State */
+static uint8_t head;            // Slot to be written next
+static uint8_t next_seq;        // Sequence number of next record
+static uint8_t record_count;    // Number of records in EEPROM
+static uint8_t boot_count;      // Cold boots (JOURNAL_BOOT_EEPROM)
+
+
+/* RAM Queue */
+static uint8_t queue[JOURNAL_QUEUE_NUM][JOURNAL_RECORD_SIZE];
+static uint8_t queue_head;
+static uint8_t queue_count;
+static uint8_t write_pos;       // Index of write_order[] being written
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Journal
+ * @param
+ *     cold:1:Cold boot (boot count is increased)
+ * @return
+ *     none:
+ * @note
+ *     Scan EEPROM to find the newest record. Records
+ *     of another JOURNAL_FORMAT are erased (blocking)
+ *===================================================*/
+void journal_init(uint8_t cold)
+{
+    uint8_t slot;
+    uint8_t seq;
+    uint8_t newest = JOURNAL_RECORD_NUM - 1;
+
+    head         = 0;
+    next_seq     = 0;
+    record_count = 0;
+    queue_head   = 0;
+    queue_count  = 0;
+    write_pos    = 0;
+
+    /* New boot count (once, before the Watchdog : erased 0xFF -> 0) */
+    boot_count = eeprom_read(JOURNAL_BOOT_EEPROM);
+    if(cold)
+    {
+        boot_count++;
+        eeprom_write_start(JOURNAL_BOOT_EEPROM, boot_count);
+        while(eeprom_busy())
+        {
+            ;
+        }
+    }
+
+    /* Records of another format are erased (once, before the Watchdog) */
+    if(eeprom_read(JOURNAL_FORMAT_EEPROM) != JOURNAL_FORMAT)
+    {
+        for(slot = 0; slot < JOURNAL_RECORD_NUM; slot++)
+        {
+            while(eeprom_busy())
+            {
+                ;
+            }
+            eeprom_write_start(slot_address(slot), JOURNAL_SEQ_ERASED);
+        }
+        while(eeprom_busy())
+        {
+            ;
+        }
+        eeprom_write_start(JOURNAL_FORMAT_EEPROM, JOURNAL_FORMAT);
+        return;
+    }
+
+    /* Empty Journal */
+    if(eeprom_read(slot_address(0)) == JOURNAL_SEQ_ERASED)
+    {
+        return;
+    }
+
+    /* Newest record is followed by a non-consecutive sequence number */
+    for(slot = 0; slot < JOURNAL_RECORD_NUM; slot++)
+    {
+        seq = eeprom_read(slot_address(slot));
+        if(eeprom_read(slot_address((slot + 1) % JOURNAL_RECORD_NUM)) != next_sequence(seq))
+        {
+            newest = slot;
+            break;
+        }
+    }
+
+    head     = (newest + 1) % JOURNAL_RECORD_NUM;
+    next_seq = next_sequence(eeprom_read(slot_address(newest)));
+
+    /* Ring is not full yet if next slot is erased */
+    if(eeprom_read(slot_address(head)) == JOURNAL_SEQ_ERASED)
+    {
+        record_count = newest + 1;
+    }
+    else
+    {
+        record_count = JOURNAL_RECORD_NUM;
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Record a Call
+ * @param
+ *     call_tick   :systick when the call was notified
+ *     outcome     :response or timeout
+ *     latency_tick:ticks until the response
+ * @return
+ *     none:
+ * @note
+ *     Only queued in RAM, never waits for EEPROM.
+ *     The record is dropped if the queue is full.
+ *===================================================*/
+void journal_record(uint32_t call_tick, journal_outcome_t outcome, uint32_t latency_tick)
+{
+    uint8_t *p_record;
+    uint32_t time_min;
+    uint32_t latency;
+
+    if(queue_count == JOURNAL_QUEUE_NUM)
+    {
+        return;
+    }
+    p_record = queue[(queue_head + queue_count) % JOURNAL_QUEUE_NUM];
+
+    /* Encode */
+    time_min = call_tick / SYSTICK_MS(JOURNAL_TIME_UNIT_MS);
+    latency  = latency_tick / SYSTICK_MS(JOURNAL_LATENCY_UNIT_MS);
+    if(latency > JOURNAL_LATENCY_MAX)
+    {
+        latency = JOURNAL_LATENCY_MAX;
+    }
+
+    p_record[0] = next_seq;
+    p_record[1] = boot_count;
+    p_record[2] = (uint8_t)time_min;
+    p_record[3] = (uint8_t)(time_min >> 8);
+    p_record[4] = (uint8_t)(time_min >> 16);
+    p_record[5] = (uint8_t)(((uint8_t)outcome << 6) | (uint8_t)latency);
+
+    next_seq = next_sequence(next_seq);
+    queue_count++;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Write queued Records to EEPROM
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Call from main loop. Starts at most 1 byte write
+ *     per call and returns at once while EEPROM is busy
+ *===================================================*/
+void journal_task(void)
+{
+    uint8_t *p_record;
+    uint8_t index;
+    uint8_t address;
+
+    if((queue_count == 0) || eeprom_busy())
+    {
+        return;
+    }
+
+    p_record = queue[queue_head];
+    index    = write_order[write_pos];
+    address  = slot_address(head) + index;
+
+    /* Skip unchanged byte (saves time and wear) */
+    if(eeprom_read(address) != p_record[index])
+    {
+        eeprom_write_start(address, p_record[index]);
+    }
+
+    /* Record completed */
+    write_pos++;
+    if(write_pos == JOURNAL_RECORD_SIZE)
+    {
+        write_pos  = 0;
+        head       = (head + 1) % JOURNAL_RECORD_NUM;
+        queue_head = (queue_head + 1) % JOURNAL_QUEUE_NUM;
+        queue_count--;
+
+        if(record_count < JOURNAL_RECORD_NUM)
+        {
+            record_count++;
+        }
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Transmit all Records via USART
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *  Response to PROTOCOL_JOURNAL_READ
+ *  --------------------------------------------------
+ *  | PROTOCOL_JOURNAL_READ                          |
+ *  | Number of records                              |
+ *  | Current boot count                             |
+ *  | Current time [min] (Low, Middle, High)         |
+ *  | Records (oldest first, 6 byte each)            |
+ *  --------------------------------------------------
+ *===================================================*/
+void journal_dump(void)
+{
+    uint8_t i;
+    uint8_t j;
+    uint8_t address;
+    uint32_t time_min;
+
+    /* Flush queued records first */
+    while((queue_count != 0) || eeprom_busy())
+    {
+        journal_task();
+    }
+
+    time_min = systick_get() / SYSTICK_MS(JOURNAL_TIME_UNIT_MS);
+
+    usart_begin_frame();
+    put_char(PROTOCOL_JOURNAL_READ);
+    put_char(record_count);
+    put_char(boot_count);
+    put_char((uint8_t)time_min);
+    put_char((uint8_t)(time_min >> 8));
+    put_char((uint8_t)(time_min >> 16));
+
+    for(i = 0; i < record_count; i++)
+    {
+        supervisor_kick();
+        address = slot_address((head + JOURNAL_RECORD_NUM - record_count + i) % JOURNAL_RECORD_NUM);
+        for(j = 0; j < JOURNAL_RECORD_SIZE; j++)
+        {
+            put_char(eeprom_read(address + j));
+        }
+    }
+    usart_end_frame();
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     EEPROM Address of Slot
+ * @param
+ *     slot:slot number
+ * @return
+ *     EEPROM address of the first byte
+ * @note
+ *     none
+ *---------------------------------------------------*/
+static uint8_t slot_address(uint8_t slot)
+{
+    return (uint8_t)(JOURNAL_EEPROM_BASE + (slot * JOURNAL_RECORD_SIZE));
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Next Sequence Number
+ * @param
+ *     seq:sequence number
+ * @return
+ *     following sequence number
+ * @note
+ *     Wraps from JOURNAL_SEQ_MAX to 0
+ *---------------------------------------------------*/
+static uint8_t next_sequence(uint8_t seq)
+{
+    if(seq >= JOURNAL_SEQ_MAX)
+    {
+        return 0;
+    }
+
+    return seq + 1;
+}
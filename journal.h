@@ -0,0 +1,147 @@
+#ifndef _JOURNAL_H
+#define _JOURNAL_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+
+
+/* Journal Area in Data EEPROM */
+#define JOURNAL_EEPROM_BASE (0x00)
+#define JOURNAL_RECORD_SIZE (6)
+#define JOURNAL_RECORD_NUM  (31)    // 186 byte
+
+
+/* Record Format in EEPROM (other value : journal is erased at boot) */
+#define JOURNAL_FORMAT_EEPROM   (0xBF)
+#define JOURNAL_FORMAT          (2)     // 6 byte record, boot count, time [min]
+
+
+/* Boot Count in EEPROM (cold boots, wraps at 255) */
+#define JOURNAL_BOOT_EEPROM     (0xBE)
+
+
+/* Header of journal_dump() : code, count, boot count, time (3 byte) */
+#define JOURNAL_DUMP_HEADER_SIZE (6)
+
+
+/* RAM Queue for records not yet written */
+#define JOURNAL_QUEUE_NUM   (4)
+
+
+/* Encoding */
+#define JOURNAL_SEQ_ERASED      (0xFF)  // Sequence number of erased slot
+#define JOURNAL_SEQ_MAX         (0xFE)  // Sequence number 0 - 254
+#define JOURNAL_TIME_UNIT_MS    (60000) // Timestamp  : 1[min]
+#define JOURNAL_LATENCY_UNIT_MS (500)   // Latency    : 0.5[s]
+#define JOURNAL_LATENCY_MAX     (0x3F)
+
+
+/* Record Format (6 byte) */
+/*---------------------------------------------------
+| Byte | Contents                                   |
+-----------------------------------------------------
+|  0   | Sequence number (0 - 254, 0xFF : erased)   |
+-----------------------------------------------------
+|  1   | Boot count of the call                     |
+-----------------------------------------------------
+|  2   | Timestamp [min] (Low)                      |
+-----------------------------------------------------
+|  3   | Timestamp [min] (Middle)                   |
+-----------------------------------------------------
+|  4   | Timestamp [min] (High)                     |
+-----------------------------------------------------
+|  5   | bit7-6 : Outcome, bit5-0 : Latency [0.5s]  |
+-----------------------------------------------------
+ There is no head pointer in EEPROM (it would wear out
+ first). The newest record is found at boot where the
+ sequence number breaks, so every slot is written once
+ per JOURNAL_RECORD_NUM calls.
+
+ Timestamp is the system tick (0 at power on, kept by
+ a warm restart) in minutes. 24 bit would last 31
+ years, so it never wraps by itself; it wraps with the
+ system tick (32 bit of 10ms, about 497 days).
+ Timestamps are comparable only within a boot count:
+ the count is increased at every cold boot, so records
+ from before a power cut are not read as recent.
+---------------------------------------------------*/
+
+
+/* Call Outcome */
+typedef enum
+{
+    JOURNAL_RESPONCE1,
+    JOURNAL_RESPONCE2,
+    JOURNAL_TIMEOUT,
+    JOURNAL_OTHER,
+} journal_outcome_t;
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Journal
+ * @param
+ *     cold:1:Cold boot (boot count is increased)
+ * @return
+ *     none:
+ * @note
+ *     Scan EEPROM to find the newest record. Records
+ *     of another JOURNAL_FORMAT are erased (blocking)
+ *===================================================*/
+void journal_init(uint8_t cold);
+
+
+/*=====================================================
+ * @brief
+ *     Record a Call
+ * @param
+ *     call_tick   :systick when the call was notified
+ *     outcome     :response or timeout
+ *     latency_tick:ticks until the response
+ * @return
+ *     none:
+ * @note
+ *     Only queued in RAM, never waits for EEPROM.
+ *     The record is dropped if the queue is full.
+ *===================================================*/
+void journal_record(uint32_t call_tick, journal_outcome_t outcome, uint32_t latency_tick);
+
+
+/*=====================================================
+ * @brief
+ *     Write queued Records to EEPROM
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Call from main loop. Starts at most 1 byte write
+ *     per call and returns at once while EEPROM is busy
+ *===================================================*/
+void journal_task(void);
+
+
+/*=====================================================
+ * @brief
+ *     Transmit all Records via USART
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *  Response to PROTOCOL_JOURNAL_READ
+ *  --------------------------------------------------
+ *  | PROTOCOL_JOURNAL_READ                          |
+ *  | Number of records                              |
+ *  | Current boot count                             |
+ *  | Current time [min] (Low, Middle, High)         |
+ *  | Records (oldest first, 6 byte each)            |
+ *  --------------------------------------------------
+ *===================================================*/
+void journal_dump(void);
+
+
+#endif  /* _JOURNAL_H */
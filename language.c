@@ -0,0 +1,135 @@
+#include <xc.h>
+#include "language.h"
+#include "eeprom.h"
+
+
+/* Pack Table (index : language_t) */
+static const message_t * const language_pack[LANGUAGE_NUM] =
+{
+    language_ja,
+    language_en,
+};
+
+/* Pack is drawn by text (blank without the font flash) */
+static const uint8_t language_text[LANGUAGE_NUM] =
+{
+    0,
+    1,
+};
+
+
+/* Selected Pack */
+static const message_t *p_pack;
+static uint8_t selected;
+static uint8_t font_found;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Language
+ * @param
+ *     font:1:Font flash found (font_init())
+ * @return
+ *     none:
+ * @note
+ *     Selection is read from LANGUAGE_EEPROM. Without
+ *     the font, only packs drawn by bitmaps can be
+ *     selected (LANGUAGE_JA)
+ *===================================================*/
+void language_init(uint8_t font)
+{
+    font_found = font;
+    selected   = eeprom_read(LANGUAGE_EEPROM);
+
+    /* Selection is kept in EEPROM for the time the font is back */
+    if((selected >= LANGUAGE_NUM) || (language_text[selected] && !font_found))
+    {
+        selected = LANGUAGE_JA;
+    }
+    p_pack = language_pack[selected];
+}
+
+
+/*=====================================================
+ * @brief
+ *     Select Language
+ * @param
+ *     language:language_t
+ * @return
+ *     1:Selected and saved, 0:No such pack or the
+ *       pack needs the font
+ * @note
+ *     Only the pack pointer is changed, the screen is
+ *     not redrawn. EEPROM write is started (waits for
+ *     a write of the journal in progress)
+ *===================================================*/
+uint8_t language_select(uint8_t language)
+{
+    if((language >= LANGUAGE_NUM) || (language_text[language] && !font_found))
+    {
+        return 0;
+    }
+
+    selected = language;
+    p_pack   = language_pack[language];
+
+    while(eeprom_busy())
+    {
+        ;
+    }
+    if(eeprom_read(LANGUAGE_EEPROM) != language)
+    {
+        eeprom_write_start(LANGUAGE_EEPROM, language);
+    }
+
+    return 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Selected Language
+ * @param
+ *     none:
+ * @return
+ *     language_t
+ * @note
+ *     none
+ *===================================================*/
+uint8_t language_get(void)
+{
+    return selected;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Message of Selected Language
+ * @param
+ *     id:message_id_t
+ * @return
+ *     pointer to descriptor in flash
+ * @note
+ *     none
+ *===================================================*/
+const message_t *language_message(uint8_t id)
+{
+    return &p_pack[id];
+}
+
+
+/*=====================================================
+ * @brief
+ *     Check Message can be Shown
+ * @param
+ *     id:message_id_t
+ * @return
+ *     1:Can be shown, 0:Drawn by text and no font flash
+ * @note
+ *     A pack drawn by bitmaps may still have messages
+ *     drawn by text (language_ja.c)
+ *===================================================*/
+uint8_t language_can_show(uint8_t id)
+{
+    return (uint8_t)((p_pack[id].kind != MESSAGE_TEXT) || font_found);
+}
@@ -0,0 +1,139 @@
+#ifndef _LANGUAGE_H
+#define _LANGUAGE_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+#include "responce.h"
+
+
+/* Language (index of the pack table of language.c) */
+typedef enum
+{
+    LANGUAGE_JA,                // language_ja.c
+    LANGUAGE_EN,                // language_en.c
+    LANGUAGE_NUM,
+} language_t;
+
+
+/* Selected Language in Data EEPROM (erased : LANGUAGE_JA) */
+#define LANGUAGE_EEPROM     (0xC1)
+
+
+/* Message Kind */
+typedef enum
+{
+    MESSAGE_BITMAP,             // Graphic data (uint8_t, 1 column / byte)
+    MESSAGE_TEXT,               // JIS X 0208 codes (uint16_t, font.h)
+} message_kind_t;
+
+
+/* Message id (same order in every pack) */
+typedef enum
+{
+    MESSAGE_DEFAULT,
+    MESSAGE_CALL,
+    MESSAGE_NOT_HERE,
+    MESSAGE_RESPONCE,           // + Responce id (responce.h)
+    MESSAGE_NUM = MESSAGE_RESPONCE + RESPONCE_NUM,
+} message_id_t;
+
+
+/* Message Descriptor (in flash) */
+/*---------------------------------------------------
+ Text longer than FONT_LINE_CHARS goes on to line 1.
+ A pack is an array of MESSAGE_NUM descriptors, made
+ with MESSAGE_BITMAP_OF() / MESSAGE_TEXT_OF().
+---------------------------------------------------*/
+typedef struct
+{
+    const void *p_data;         // Graphic data or JIS X 0208 codes
+    uint8_t kind;               // message_kind_t
+    uint8_t len;                // Bytes or characters
+} message_t;
+
+#define MESSAGE_BITMAP_OF(array) \
+    {array, MESSAGE_BITMAP, (uint8_t)(sizeof(array) / sizeof(array[0]))}
+#define MESSAGE_TEXT_OF(array) \
+    {array, MESSAGE_TEXT, (uint8_t)(sizeof(array) / sizeof(array[0]))}
+
+
+/* Language Packs */
+extern const message_t language_ja[MESSAGE_NUM];
+extern const message_t language_en[MESSAGE_NUM];
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Language
+ * @param
+ *     font:1:Font flash found (font_init())
+ * @return
+ *     none:
+ * @note
+ *     Selection is read from LANGUAGE_EEPROM. Without
+ *     the font, only packs drawn by bitmaps can be
+ *     selected (LANGUAGE_JA)
+ *===================================================*/
+void language_init(uint8_t font);
+
+
+/*=====================================================
+ * @brief
+ *     Select Language
+ * @param
+ *     language:language_t
+ * @return
+ *     1:Selected and saved, 0:No such pack or the
+ *       pack needs the font
+ * @note
+ *     Only the pack pointer is changed, the screen is
+ *     not redrawn. EEPROM write is started (waits for
+ *     a write of the journal in progress)
+ *===================================================*/
+uint8_t language_select(uint8_t language);
+
+
+/*=====================================================
+ * @brief
+ *     Get Selected Language
+ * @param
+ *     none:
+ * @return
+ *     language_t
+ * @note
+ *     none
+ *===================================================*/
+uint8_t language_get(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get Message of Selected Language
+ * @param
+ *     id:message_id_t
+ * @return
+ *     pointer to descriptor in flash
+ * @note
+ *     none
+ *===================================================*/
+const message_t *language_message(uint8_t id);
+
+
+/*=====================================================
+ * @brief
+ *     Check Message can be Shown
+ * @param
+ *     id:message_id_t
+ * @return
+ *     1:Can be shown, 0:Drawn by text and no font flash
+ * @note
+ *     A pack drawn by bitmaps may still have messages
+ *     drawn by text (language_ja.c)
+ *===================================================*/
+uint8_t language_can_show(uint8_t id);
+
+
+#endif  /* _LANGUAGE_H */
@@ -0,0 +1,74 @@
+#include <xc.h>
+#include "language.h"
+
+
+/* Messages (full width Latin of JIS X 0208, 12 characters per line) */
+static const uint16_t text_default[] =    // "Please press" / "the button."
+{
+    0x2350, 0x236C, 0x2365, 0x2361, 0x2373, 0x2365, 0x2121, 0x2370,
+    0x2372, 0x2365, 0x2373, 0x2373,
+    0x2374, 0x2368, 0x2365, 0x2121, 0x2362, 0x2375, 0x2374, 0x2374,
+    0x236F, 0x236E, 0x2125,
+};
+
+static const uint16_t text_call[] =       // "Calling..."
+{
+    0x2343, 0x2361, 0x236C, 0x236C, 0x2369, 0x236E, 0x2367, 0x2125,
+    0x2125, 0x2125,
+};
+
+static const uint16_t text_not_here[] =   // "No answer."
+{
+    0x234E, 0x236F, 0x2121, 0x2361, 0x236E, 0x2373, 0x2377, 0x2365,
+    0x2372, 0x2125,
+};
+
+static const uint16_t text_coming[] =     // "Coming now."
+{
+    0x2343, 0x236F, 0x236D, 0x2369, 0x236E, 0x2367, 0x2121, 0x236E,
+    0x236F, 0x2377, 0x2125,
+};
+
+static const uint16_t text_come_in[] =    // "Please come " / "in."
+{
+    0x2350, 0x236C, 0x2365, 0x2361, 0x2373, 0x2365, 0x2121, 0x2363,
+    0x236F, 0x236D, 0x2365, 0x2121,
+    0x2369, 0x236E, 0x2125,
+};
+
+static const uint16_t text_wait[] =       // "Please wait " / "a moment."
+{
+    0x2350, 0x236C, 0x2365, 0x2361, 0x2373, 0x2365, 0x2121, 0x2377,
+    0x2361, 0x2369, 0x2374, 0x2121,
+    0x2361, 0x2121, 0x236D, 0x236F, 0x236D, 0x2365, 0x236E, 0x2374,
+    0x2125,
+};
+
+static const uint16_t text_leave[] =      // "Please leave" / "it here."
+{
+    0x2350, 0x236C, 0x2365, 0x2361, 0x2373, 0x2365, 0x2121, 0x236C,
+    0x2365, 0x2361, 0x2376, 0x2365,
+    0x2369, 0x2374, 0x2121, 0x2368, 0x2365, 0x2372, 0x2365, 0x2125,
+};
+
+static const uint16_t text_absent[] =     // "Nobody is at" / "home now."
+{
+    0x234E, 0x236F, 0x2362, 0x236F, 0x2364, 0x2379, 0x2121, 0x2369,
+    0x2373, 0x2121, 0x2361, 0x2374,
+    0x2368, 0x236F, 0x236D, 0x2365, 0x2121, 0x236E, 0x236F, 0x2377,
+    0x2125,
+};
+
+
+/* English Pack (order of message_id_t, then RESPONCE_LIST) */
+const message_t language_en[MESSAGE_NUM] =
+{
+    MESSAGE_TEXT_OF(text_default),
+    MESSAGE_TEXT_OF(text_call),
+    MESSAGE_TEXT_OF(text_not_here),
+    MESSAGE_TEXT_OF(text_coming),           // RESPONCE1
+    MESSAGE_TEXT_OF(text_come_in),          // RESPONCE2
+    MESSAGE_TEXT_OF(text_wait),             // RESPONCE_WAIT
+    MESSAGE_TEXT_OF(text_leave),            // RESPONCE_LEAVE
+    MESSAGE_TEXT_OF(text_absent),           // RESPONCE_ABSENT
+};
@@ -0,0 +1,297 @@
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include "language.h"
+
+
+/* Default Message HEAD */    
+static const uint8_t default_message[] =
+{
+    0x00      ,  //
+    0b00100000,  //   *
+    0b01010010,  //  * *  *
+    0b01000011,  //  *    **
+    0b01000010,  //  *    *
+    0b01000001,  //  *     *
+    0x00      ,  //
+    0b01111111,  //  *******
+    0b00010101,  //    * * *
+    0b01111111,  //  *******
+    0b00010101,  //    * * *
+    0b01111111,  //  *******
+    0x00      ,  //
+    0b00111100,  //   ****
+    0b00100010,  //   *   *
+    0b00011110,  //    ****
+    0b01000010,  //  *    *
+    0b00111100,  //   ****
+    0x00      ,  //
+    0b01000010,  //  *    *
+    0b00111110,  //   *****
+    0b00001011,  //     * **
+    0b01001010,  //  *  * *
+    0b01111010,  //  **** *
+    0x00      ,  //
+    0b01111111,  //  *******
+    0b00100000,  //   *
+    0b01010100,  //  * * *
+    0b00111111,  //   ******
+    0b00100100,  //   *  *
+    0x00      ,  //
+    0b00100000,  //   *
+    0b01000000,  //  *
+    0x00      ,  //
+    0b00110100,  //   ** *
+    0b00000100,  //      *
+    0b01111111,  //  *******
+    0b00000100,  //      *
+    0b00110101,  //   ** * *
+    0x00      ,  //
+    0b01001000,  //  *  *
+    0b01000100,  //  *   *
+    0b00101011,  //   * * **
+    0b00010010,  //    *  *
+    0b00001110,  //     ***
+    0x00      ,  //
+    0b01000001,  //  *     *
+    0b01000010,  //  *    *
+    0b00100000,  //   *
+    0b00010000,  //    *
+    0b00001100,  //     **
+    0x00      ,  //
+    0b00010010,  //    *  *
+    0b00101110,  //   * ***
+    0b01011011,  //  * ** **
+    0b01001010,  //  *  * *
+    0b01010100,  //  * * *   
+    0x00      ,  //
+    0b01010010,  //  * *  *
+    0b01111111,  //  *******
+    0b00011111,  //    *****
+    0b01110101,  //  *** * *
+    0b00111111,  //   ******
+    0x00      ,  //
+    0b00000000,  //
+    0b00111111,  //   ******
+    0b01000000,  //  *
+    0b01000000,  //  *
+    0b00100000,  //   *
+    0x00      ,  //
+    0b00000010,  //       *
+    0b00000010,  //       *
+    0b00011101,  //    *** *
+    0b00100011,  //   *   **
+    0b01000001,  //  *     *
+    0x00      ,  //
+    0b00000001,  //        *
+    0b00000001,  //        *
+    0b01111111,  //  *******
+    0b00000101,  //      * *
+    0b00001001,  //     *  *
+    0x00      ,  //
+    0b00100100,  //   *  *
+    0b01010100,  //  * * *
+    0b01000111,  //  *   ***
+    0b01011100,  //  * ***
+    0b00000100,  //      *
+    0x00      ,  //
+    0b00111110,  //   *****
+    0b01000000,  //  *
+    0b00100000,  //   *
+    0b00000010,  //       *
+    0b00011100,  //    ***
+    0x00      ,  //
+    0b00100000,  //   *
+    0b01010000,  //  * *
+    0b00100000   //   *   
+};
+
+/* Call Message */
+static const uint8_t call_message[] = 
+{
+    0x00      ,  //
+    0b00011110,  //    ****
+    0b00011110,  //    ****
+    0b01010010,  //  * *  *
+    0b01111110,  //  ******
+    0b00010101,  //    * * *
+    0x00      ,  //
+    0b01110110,  //  *** **
+    0b01000100,  //  *   *
+    0b01111111,  //  *******
+    0b01000100,  //  *   *
+    0b01110110,  //  *** **
+    0x00      ,  //
+    0b00011110,  //    ****
+    0b00010010,  //    *  *
+    0b01111111,  //  *******
+    0b00010010,  //    *  *
+    0b00011110,  //    ****
+    0x00      ,  //
+    0b00010000,  //    *
+    0x00      ,  //
+    0b00010000,  //    *
+    0x00      ,  //
+    0b00010000   //    *
+};
+
+/* Not be here Message */
+static const uint8_t not_here_message[] = 
+{
+    0x00      ,  //    
+    0b00010100,  //    * *  
+    0b01010010,  //  * *  * 
+    0b01010101,  //  * * * *
+    0b00110110,  //   ** ** 
+    0b00010100,  //    * *
+    0x00      ,  //
+    0b00110010,  //   **  *
+    0b01111111,  //  *******
+    0b00001010,  //     * *
+    0b01001001,  //  *  *  *
+    0b00110010,  //   **  *
+    0x00      ,  //
+    0b00000000,  //
+    0b00001111,  //     ****
+    0b01000010,  //  *    *
+    0b00100001,  //   *    *
+    0b00011110,  //    ****
+    0x00      ,  //
+    0b01101010,  //  ** * *
+    0b01101010,  //  ** * *
+    0b01111111,  //  *******
+    0b00101010,  //   * * *
+    0b01001010,  //  *  * *
+    0x00      ,  // 
+    0b00000100,  //      *
+    0b00111111,  //   ******
+    0b01000100,  //  *   *
+    0b01011111,  //  * *****
+    0b01000100,  //  *   *
+    0x00      ,  //
+    0b01100000,  //  **
+    0b00011100,  //    ***
+    0b00110011,  //   **  **
+    0b01000000,  //  *
+    0b00100000,  //   *
+    0x00      ,  //
+    0b00100000,  //   *
+    0b01010000,  //  * *
+    0b00100000   //   *   
+};
+
+
+/* Responce1 "今参ります。" */
+static const uint8_t responce_1[] = 
+{
+    0x00      ,  //    
+    0b00010100,  //    * *  
+    0b01010010,  //  * *  * 
+    0b01010101,  //  * * * *
+    0b00110110,  //   ** ** 
+    0b00010100,  //    * *
+    0x00      ,  //
+    0b00010100,  //    * *
+    0b01001110,  //  *  ***
+    0b01010101,  //  * * * *
+    0b00101100,  //   * **
+    0b00010110,  //    * **
+    0x00      ,  //
+    0b00000000,  //
+    0b00001111,  //     ****
+    0b01000010,  //  *    *
+    0b00100001,  //   *    *
+    0b00011110,  //    ****
+    0x00      ,  //
+    0b01101010,  //  ** * *
+    0b01101010,  //  ** * *
+    0b01111111,  //  *******
+    0b00101010,  //   * * *
+    0b01001010,  //  *  * *
+    0x00      ,  //
+    0b00000010,  //       *
+    0b00001010,  //     * *
+    0b01010110,  //  * * **
+    0b00111111,  //   ******
+    0b00000010,  //       *
+    0x00      ,  //
+    0b00100000,  //   *
+    0b01010000,  //  * *
+    0b00100000   //   *
+};
+
+/* Responce2 "お入りください。" */
+static const uint8_t responce_2[] =
+{
+    0x00      ,  //
+    0b00110010,  //   **  *
+    0b01111111,  //  *******
+    0b00001010,  //     * *
+    0b01001001,  //  *  *  *
+    0b00110010,  //   **  *
+    0x00      ,  //
+    0b01000000,  //  *
+    0b00110001,  //   **   *
+    0b00001111,  //     ****
+    0b00110000,  //   **
+    0b01000000,  //  *
+    0x00      ,  //
+    0b00000000,  //
+    0b00001111,  //     ****
+    0b01000010,  //  *    *
+    0b00100001,  //   *    *
+    0b00011110,  //    ****
+    0x00      ,  //
+    0b00000001,  //        *
+    0b00000001,  //        *
+    0b01111111,  //  *******
+    0b00000101,  //      * *
+    0b00001001,  //     *  *
+    0x00      ,  //
+    0b00100100,  //   *  *
+    0b01010100,  //  * * *
+    0b01000111,  //  *   ***
+    0b01011100,  //  * ***
+    0b00000100,  //      *
+    0x00      ,  //
+    0b00111110,  //   *****
+    0b01000000,  //  *
+    0b00100000,  //   *
+    0b00000010,  //       *
+    0b00011100,  //    ***
+    0x00      ,  //
+    0b00100000,  //   *
+    0b01010000,  //  * *
+    0b00100000   //   *   
+};
+
+
+/* Responce Messages (JIS X 0208, need the font flash : not taken without it) */
+static const uint16_t text_wait[] =       // 少々お待ち下さい。
+{
+    0x3E2F, 0x2139, 0x242A, 0x4254, 0x2441, 0x323C, 0x2435, 0x2424, 0x2123,
+};
+
+static const uint16_t text_leave[] =      // 置いて下さい。
+{
+    0x4356, 0x2424, 0x2446, 0x323C, 0x2435, 0x2424, 0x2123,
+};
+
+static const uint16_t text_absent[] =     // 只今留守です。
+{
+    0x427E, 0x3A23, 0x4E31, 0x3C69, 0x2447, 0x2439, 0x2123,
+};
+
+
+/* Japanese Pack (order of message_id_t, then RESPONCE_LIST) */
+const message_t language_ja[MESSAGE_NUM] =
+{
+    MESSAGE_BITMAP_OF(default_message),
+    MESSAGE_BITMAP_OF(call_message),
+    MESSAGE_BITMAP_OF(not_here_message),
+    MESSAGE_BITMAP_OF(responce_1),          // RESPONCE1
+    MESSAGE_BITMAP_OF(responce_2),          // RESPONCE2
+    MESSAGE_TEXT_OF(text_wait),             // RESPONCE_WAIT
+    MESSAGE_TEXT_OF(text_leave),            // RESPONCE_LEAVE
+    MESSAGE_TEXT_OF(text_absent),           // RESPONCE_ABSENT
+};
@@ -0,0 +1,171 @@
+#include <xc.h>
+#include "latency.h"
+#include "systick.h"
+#include "usart.h"
+#include "supervisor.h"
+
+
+/* Histogram Bin upper bound [SYSTICK_PERIOD_MS] */
+static const uint8_t bin_bound[LATENCY_BIN_NUM] =
+{
+    SYSTICK_MS(50),
+    SYSTICK_MS(100),
+    SYSTICK_MS(150),
+    SYSTICK_MS(200),
+    SYSTICK_MS(300),
+    SYSTICK_MS(500),
+    SYSTICK_MS(1000),
+    LATENCY_BIN_OPEN,
+};
+
+
+static uint16_t histogram[LATENCY_STAGE_NUM][LATENCY_BIN_NUM];
+static volatile uint32_t edge_tick;
+static volatile uint8_t  edge_valid;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Latency Histograms
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void latency_init(void)
+{
+    uint8_t stage;
+    uint8_t bin;
+
+    for(stage = 0; stage < LATENCY_STAGE_NUM; stage++)
+    {
+        for(bin = 0; bin < LATENCY_BIN_NUM; bin++)
+        {
+            histogram[stage][bin] = 0;
+        }
+    }
+    edge_valid = 0;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Record Button edge
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from isr(). Only the first edge of a call
+ *     is kept, chattering edges are ignored until
+ *     latency_clear()
+ *===================================================*/
+void latency_edge(void)
+{
+    if(edge_valid == 0)
+    {
+        edge_tick  = systick_get();
+        edge_valid = 1;
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Record Stage of Call
+ * @param
+ *     stage:stage reached
+ * @return
+ *     none:
+ * @note
+ *     Time from the Button edge is added to the
+ *     histogram of the stage
+ *===================================================*/
+void latency_mark(latency_stage_t stage)
+{
+    uint32_t elapsed;
+    uint8_t bin;
+
+    if(edge_valid == 0)
+    {
+        return;
+    }
+
+    /* edge_tick does not change while edge_valid is set */
+    elapsed = systick_get() - edge_tick;
+
+    for(bin = 0; bin < (LATENCY_BIN_NUM - 1); bin++)
+    {
+        if(elapsed < bin_bound[bin])
+        {
+            break;
+        }
+    }
+
+    if(histogram[stage][bin] < 0xFFFF)
+    {
+        histogram[stage][bin]++;
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Wait for next Button edge
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called when the call is finished
+ *===================================================*/
+void latency_clear(void)
+{
+    edge_valid = 0;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Transmit Histograms via USART
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *  Response to PROTOCOL_LATENCY_READ
+ *  --------------------------------------------------
+ *  | PROTOCOL_LATENCY_READ                          |
+ *  | LATENCY_STAGE_NUM, LATENCY_BIN_NUM             |
+ *  | Bin upper bounds [10ms] (LATENCY_BIN_NUM byte) |
+ *  | Counts (Low, High) of each bin, stage by stage |
+ *  --------------------------------------------------
+ *===================================================*/
+void latency_dump(void)
+{
+    uint8_t stage;
+    uint8_t bin;
+
+    usart_begin_frame();
+    put_char(PROTOCOL_LATENCY_READ);
+    put_char(LATENCY_STAGE_NUM);
+    put_char(LATENCY_BIN_NUM);
+
+    for(bin = 0; bin < LATENCY_BIN_NUM; bin++)
+    {
+        put_char(bin_bound[bin]);
+    }
+
+    for(stage = 0; stage < LATENCY_STAGE_NUM; stage++)
+    {
+        supervisor_kick();
+        for(bin = 0; bin < LATENCY_BIN_NUM; bin++)
+        {
+            put_char((uint8_t)histogram[stage][bin]);
+            put_char((uint8_t)(histogram[stage][bin] >> 8));
+        }
+    }
+    usart_end_frame();
+}
@@ -0,0 +1,113 @@
+#ifndef _LATENCY_H
+#define _LATENCY_H
+
+#include <xc.h>
+#include <stdint.h>
+
+
+/* Stage of Call (time from the Button edge) */
+/*---------------------------------------------------
+| Stage    | Measured when                          |
+-----------------------------------------------------
+| DEBOUNCE | Chattering wait is over                |
+-----------------------------------------------------
+| NOTIFY   | Notification is transmitted            |
+|          | (Multi-drop : ACK is received)         |
+-----------------------------------------------------
+| DISPLAY  | Call Message is on the display         |
+---------------------------------------------------*/
+typedef enum
+{
+    LATENCY_DEBOUNCE,
+    LATENCY_NOTIFY,
+    LATENCY_DISPLAY,
+    LATENCY_STAGE_NUM,
+} latency_stage_t;
+
+
+/* Histogram Bin (upper bound [SYSTICK_PERIOD_MS], last bin is open) */
+/*---------------------------------------------------
+| Bin   |  0 |  1  |  2  |  3  |  4  |  5  |  6   |  7    |
+-----------------------------------------------------------
+| [ms]  | 50 | 100 | 150 | 200 | 300 | 500 | 1000 | over  |
+---------------------------------------------------------*/
+#define LATENCY_BIN_NUM     (8)
+#define LATENCY_BIN_OPEN    (0xFF)
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Latency Histograms
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void latency_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Record Button edge
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from isr(). Only the first edge of a call
+ *     is kept, chattering edges are ignored until
+ *     latency_clear()
+ *===================================================*/
+void latency_edge(void);
+
+
+/*=====================================================
+ * @brief
+ *     Record Stage of Call
+ * @param
+ *     stage:stage reached
+ * @return
+ *     none:
+ * @note
+ *     Time from the Button edge is added to the
+ *     histogram of the stage
+ *===================================================*/
+void latency_mark(latency_stage_t stage);
+
+
+/*=====================================================
+ * @brief
+ *     Wait for next Button edge
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called when the call is finished
+ *===================================================*/
+void latency_clear(void);
+
+
+/*=====================================================
+ * @brief
+ *     Transmit Histograms via USART
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *  Response to PROTOCOL_LATENCY_READ
+ *  --------------------------------------------------
+ *  | PROTOCOL_LATENCY_READ                          |
+ *  | LATENCY_STAGE_NUM, LATENCY_BIN_NUM             |
+ *  | Bin upper bounds [10ms] (LATENCY_BIN_NUM byte) |
+ *  | Counts (Low, High) of each bin, stage by stage |
+ *  --------------------------------------------------
+ *===================================================*/
+void latency_dump(void);
+
+
+#endif  /* _LATENCY_H */
@@ -0,0 +1,292 @@
+#include <xc.h>
+#include "link.h"
+#include "usart.h"
+#include "protocol.h"
+#include "timer_wheel.h"
+#include "bt_module.h"
+
+
+/* Prototype of Static Function */
+static void send_ping(void);
+static void update_rto(uint16_t rtt);
+
+
+/* RTO Limit [tick] */
+#define RTO_MIN     ((uint16_t)SYSTICK_MS(LINK_RTO_MIN_MS))
+#define RTO_MAX     ((uint16_t)SYSTICK_MS(LINK_RTO_MAX_MS))
+
+
+/* Link */
+static uint8_t  link_up;
+static uint8_t  pending;        // Ping without reply
+static uint8_t  misses;         // Lost in a row
+static uint8_t  lost;
+static uint32_t ping_tick;
+
+/* RTT [tick] */
+static uint16_t srtt8;          // SRTT x 8 (0 : no sample)
+static uint16_t rttvar4;        // RTTVAR x 4
+static uint16_t rto;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Link Monitor
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Link is regarded as up until heartbeats are
+ *     lost. Call after timer_init()
+ *===================================================*/
+void link_init(void)
+{
+    link_up = 1;
+    pending = 0;
+    misses  = 0;
+    lost    = 0;
+    srtt8   = 0;
+    rttvar4 = 0;
+    rto     = SYSTICK_MS(LINK_RTO_INIT_MS);
+
+    timer_start(TIMER_LINK, 0);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Link Monitor Task
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from main loop, never waits for the
+ *     reply. Nothing is sent while the Bluetooth
+ *     module is in AT command mode
+ *===================================================*/
+void link_task(void)
+{
+    if(bt_get_event() == BT_EVENT_LINK_UP)
+    {
+        /* Ping in flight was lost with the Bluetooth link */
+        pending = 0;
+        link_probe();
+    }
+
+    if(bt_command_mode() || !bt_link_up())
+    {
+        return;
+    }
+    if(timer_expired(TIMER_LINK) == 0)
+    {
+        return;
+    }
+
+    if(pending)
+    {
+        /* No reply within RTO */
+        pending = 0;
+        lost++;
+        if(misses < LINK_MISS_MAX)
+        {
+            misses++;
+        }
+        if(misses < LINK_MISS_MAX)
+        {
+            send_ping();
+            return;
+        }
+
+        /* Link is down, try again at the heartbeat interval */
+        link_up = 0;
+        timer_start(TIMER_LINK, TIMER_TICKS(LINK_HEARTBEAT_MS));
+        return;
+    }
+    send_ping();
+}
+
+
+/*=====================================================
+ * @brief
+ *     Send Heartbeat at once
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called after the call notification, so that a
+ *     lost handset is found within LINK_MISS_MAX x RTO
+ *===================================================*/
+void link_probe(void)
+{
+    if(bt_command_mode() || !bt_link_up())
+    {
+        return;
+    }
+
+    /* Reply to the ping in flight is still measured */
+    if(pending == 0)
+    {
+        misses = 0;
+        send_ping();
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Take Heartbeat Reply
+ * @param
+ *     data:received data
+ * @return
+ *     1:Heartbeat reply (taken), 0:Other data
+ * @note
+ *     Every received byte is passed here first
+ *===================================================*/
+uint8_t link_receive(uint8_t data)
+{
+    if(data != PROTOCOL_PONG)
+    {
+        return 0;
+    }
+
+    /* Late reply after the timeout is not a sample */
+    if(pending)
+    {
+        pending = 0;
+        update_rto((uint16_t)(systick_get() - ping_tick) + 1);
+        timer_start(TIMER_LINK, TIMER_TICKS(LINK_HEARTBEAT_MS));
+    }
+    misses  = 0;
+    link_up = 1;
+
+    return 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Check Link to Handset
+ * @param
+ *     none:
+ * @return
+ *     1:Up, 0:Down
+ * @note
+ *     none
+ *===================================================*/
+uint8_t link_is_up(void)
+{
+    return (link_up && bt_link_up() && !bt_command_mode());
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Smoothed RTT
+ * @param
+ *     none:
+ * @return
+ *     SRTT [ms] (0 : no sample yet)
+ * @note
+ *     none
+ *===================================================*/
+uint16_t link_get_srtt(void)
+{
+    return (uint16_t)((srtt8 >> 3) * SYSTICK_PERIOD_MS);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Retransmission Timeout
+ * @param
+ *     none:
+ * @return
+ *     RTO [ms]
+ * @note
+ *     none
+ *===================================================*/
+uint16_t link_get_rto(void)
+{
+    return (uint16_t)(rto * SYSTICK_PERIOD_MS);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Lost Heartbeat Count
+ * @param
+ *     none:
+ * @return
+ *     heartbeats without reply (wraps at 255)
+ * @note
+ *     none
+ *===================================================*/
+uint8_t link_get_lost(void)
+{
+    return lost;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Send Heartbeat and wait RTO for the reply
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *---------------------------------------------------*/
+static void send_ping(void)
+{
+    usart_send_frame(PROTOCOL_PING);
+
+    ping_tick = systick_get();
+    pending   = 1;
+    timer_start(TIMER_LINK, rto);
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Update RTO with RTT Sample
+ * @param
+ *     rtt:RTT [tick] (rounded up)
+ * @return
+ *     none:
+ * @note
+ *     RFC 6298 with the scaled integers of link.h
+ *---------------------------------------------------*/
+static void update_rto(uint16_t rtt)
+{
+    int16_t delta;
+
+    if(srtt8 == 0)
+    {
+        srtt8   = (uint16_t)(rtt << 3);
+        rttvar4 = (uint16_t)(rtt << 1);
+    }
+    else
+    {
+        delta  = (int16_t)(rtt - (srtt8 >> 3));
+        srtt8 += delta;
+        if(delta < 0)
+        {
+            delta = -delta;
+        }
+        rttvar4 += delta - (int16_t)(rttvar4 >> 2);
+    }
+
+    rto = (uint16_t)((srtt8 >> 3) + rttvar4);
+    if(rto < RTO_MIN)
+    {
+        rto = RTO_MIN;
+    }
+    else if(rto > RTO_MAX)
+    {
+        rto = RTO_MAX;
+    }
+}
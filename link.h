@@ -0,0 +1,155 @@
+#ifndef _LINK_H
+#define _LINK_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+#include "systick.h"
+
+
+/* Heartbeat (PROTOCOL_PING -> PROTOCOL_PONG) */
+/*---------------------------------------------------
+| Event                | Next Ping                  |
+-----------------------------------------------------
+| Reply received       | after LINK_HEARTBEAT_MS    |
+-----------------------------------------------------
+| No reply within RTO  | at once, LINK_MISS_MAX - 1 |
+|                      | times                      |
+-----------------------------------------------------
+| Link is down         | after LINK_HEARTBEAT_MS    |
+-----------------------------------------------------
+| Call is notified     | at once (link_probe)       |
+-----------------------------------------------------
+ A call to a handset which is out of range is ended
+ after LINK_MISS_MAX x RTO (hundreds of ms) instead of
+ CALL_RESPONCE_MS. Bluetooth STATE low is link down
+ at once (BT_STATE_PIN; without it only the heartbeat).
+---------------------------------------------------*/
+#define LINK_HEARTBEAT_MS   (2000)
+#define LINK_MISS_MAX       (2)
+
+
+/* Retransmission Timeout from RTT samples [SYSTICK_PERIOD_MS] */
+/*---------------------------------------------------
+ SRTT   <- SRTT + (RTT - SRTT) / 8
+ RTTVAR <- RTTVAR + (|RTT - SRTT| - RTTVAR) / 4
+ RTO     = SRTT + 4 x RTTVAR  (LINK_RTO_MIN - MAX)
+ SRTT is kept x8 and RTTVAR x4, so only shifts are
+ used. RTO is LINK_RTO_INIT_MS until the 1st sample.
+---------------------------------------------------*/
+#define LINK_RTO_INIT_MS    (500)
+#define LINK_RTO_MIN_MS     (50)
+#define LINK_RTO_MAX_MS     (1000)
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Link Monitor
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Link is regarded as up until heartbeats are
+ *     lost. Call after timer_init()
+ *===================================================*/
+void link_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Link Monitor Task
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from main loop, never waits for the
+ *     reply. Nothing is sent while the Bluetooth
+ *     module is in AT command mode
+ *===================================================*/
+void link_task(void);
+
+
+/*=====================================================
+ * @brief
+ *     Send Heartbeat at once
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called after the call notification, so that a
+ *     lost handset is found within LINK_MISS_MAX x RTO
+ *===================================================*/
+void link_probe(void);
+
+
+/*=====================================================
+ * @brief
+ *     Take Heartbeat Reply
+ * @param
+ *     data:received data
+ * @return
+ *     1:Heartbeat reply (taken), 0:Other data
+ * @note
+ *     Every received byte is passed here first
+ *===================================================*/
+uint8_t link_receive(uint8_t data);
+
+
+/*=====================================================
+ * @brief
+ *     Check Link to Handset
+ * @param
+ *     none:
+ * @return
+ *     1:Up, 0:Down
+ * @note
+ *     none
+ *===================================================*/
+uint8_t link_is_up(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get Smoothed RTT
+ * @param
+ *     none:
+ * @return
+ *     SRTT [ms] (0 : no sample yet)
+ * @note
+ *     none
+ *===================================================*/
+uint16_t link_get_srtt(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get Retransmission Timeout
+ * @param
+ *     none:
+ * @return
+ *     RTO [ms]
+ * @note
+ *     none
+ *===================================================*/
+uint16_t link_get_rto(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get Lost Heartbeat Count
+ * @param
+ *     none:
+ * @return
+ *     heartbeats without reply (wraps at 255)
+ * @note
+ *     none
+ *===================================================*/
+uint8_t link_get_lost(void);
+
+
+#endif  /* _LINK_H */
@@ -1,13 +1,35 @@
 #include <xc.h>
 #include "pic_clock.h"
 #include "oled_lcd_lib.h"
+#include "oled_bus.h"
 #include "word_graphic.h"
 #include "usart.h"
+#include "protocol.h"
+#include "button_interrupt.h"
+#include "systick.h"
+#include "journal.h"
+#include "perf.h"
+#include "latency.h"
+#include "timer_wheel.h"
+#include "chime.h"
+#include "bootloader.h"
+#include "bt_module.h"
+#include "link.h"
+#include "call_manager.h"
+#include "font.h"
+#include "marquee.h"
+#include "animation.h"
+#include "transition.h"
+#include "pool.h"
+#include "irq.h"
+#include "responce.h"
+#include "language.h"
+#include "supervisor.h"
 
 
 // CONFIG1
 #pragma config FOSC     = HS  // Oscillator Selection (HS Oscillator, High-speed crystal/resonator connected between OSC1 and OSC2 pins)
-#pragma config WDTE     = OFF // Watchdog Timer Enable (WDT disabled)
+#pragma config WDTE     = SWDTEN // Watchdog Timer Enable (WDT controlled by the SWDTEN bit in the WDTCON register)
 #pragma config PWRTE    = ON  // Power-up Timer Enable (PWRT enabled)
 #pragma config MCLRE    = OFF // MCLR Pin Function Select (MCLR/VPP pin function is digital input)
 #pragma config CP       = OFF // Flash Program Memory Code Protection (Program memory code protection is disabled)
@@ -21,15 +43,79 @@
 #pragma config WRT      = OFF // Flash Memory Self-Write Protection (Write protection off)
 #pragma config VCAPEN   = OFF // Voltage Regulator Capacitor Enable (All VCAP pin functionality is disabled)
 #pragma config PLLEN    = OFF // PLL Enable (4x PLL disabled)
-#pragma config STVREN   = OFF // Stack Overflow/Underflow Reset Enable (Stack Overflow or Underflow will not cause a Reset)
+#pragma config STVREN   = ON  // Stack Overflow/Underflow Reset Enable (Stack Overflow or Underflow will cause a Reset)
 #pragma config BORV     = LO  // Brown-out Reset Voltage Selection (Brown-out Reset Voltage (Vbor), low trip point selected.)
 #pragma config LVP      = OFF // Low-Voltage Programming Enable (High-voltage on MCLR/VPP must be used for programming)
 
 
+/* Call State */
+/*---------------------------------------------------
+| State    | Leaves when                            |
+-----------------------------------------------------
+| IDLE     | Call is queued by call_press()         |
+-----------------------------------------------------
+| DEBOUNCE | TIMER_DEBOUNCE -> notify, Call Message |
+-----------------------------------------------------
+| WAIT     | Responce received or TIMER_RESPONCE    |
+|          | (repeat presses : TIMER_CALL_UPDATE)   |
+-----------------------------------------------------
+| HOLD     | TIMER_HOLD -> Default Message          |
+|          | Next call in the queue -> IDLE at once |
+---------------------------------------------------*/
+typedef enum
+{
+    CALL_IDLE,
+    CALL_DEBOUNCE,
+    CALL_WAIT,
+    CALL_HOLD,
+} call_state_t;
+
+
+/* Call Timing */
+#define CALL_DEBOUNCE_MS    (100)
+#define CALL_RESPONCE_MS    (20000)
+#define CALL_HOLD_MS        (20000)     // Not Here Message (Responce : responce.h)
+
+
+/* Screen on the display (restored by a warm restart) */
+typedef enum
+{
+    SCREEN_DEFAULT,
+    SCREEN_CALL,
+    SCREEN_NOT_HERE,
+    SCREEN_RESPONCE,            // + Responce id
+} screen_t;
+
+
+/* Wait Indicator (under and next to the Call Message) */
+#define WAIT_SPINNER_X      (28)
+#define WAIT_SPINNER_LINE   (0)
+#define WAIT_PROGRESS_LINE  (1)
+
+
 /* Prototype of Static Function */
 static void pic_port_init(void);
 static void interrupt isr(void);
-static void receive_sequence(void);
+static void call_sequence(void);
+static void call_notify(void);
+static void call_hold(uint16_t ticks);
+static void call_update(void);
+static void command_sequence(uint8_t receive_data);
+static void receive_sequence(uint8_t id);
+static uint8_t receive_responce(uint8_t *p_id);
+static void show_screen(uint8_t next);
+static void call_save(uint16_t ticks);
+static void call_restore(const warm_state_t *p_warm);
+#if !USART_MULTIDROP
+static uint8_t boot_key_received(void);
+#endif
+
+
+/* Call */
+static call_state_t call_state;
+static uint8_t call_button;
+static uint32_t notify_tick;
+static uint8_t screen;         // screen_t
 
 
 /******************************************************
@@ -37,24 +123,121 @@ static void receive_sequence(void);
  *****************************************************/
 int main(void)
 {      
+    uint8_t receive_data;
+    uint8_t display_ok;
+    warm_state_t warm;
+    reset_cause_t cause;
+
+    /* Reset flags are read before anything else */
+    cause = supervisor_init(&warm);
+
     /* Initialize Sequence */
+    clock_init();
     pic_port_init();
+    pool_init();
     usart_init();
+    timer_init();
+    chime_init();
+    systick_init();
+    if(cause != RESET_COLD)
+    {
+        /* Saved deadlines are in ticks */
+        systick_resume(supervisor_get_tick());
+    }
+#if PERF_ENABLE
+    perf_init();
+#endif
+    journal_init(cause == RESET_COLD);
+    latency_init();
+    bt_init();
+    link_init();
+    call_init();
+    marquee_init();
+    anim_init();
+    if((cause != RESET_COLD) && (warm.call_state == CALL_DEBOUNCE))
+    {
+        /* Press being debounced is queued again (before interrupts) */
+        call_press(warm.call_button);
+    }
     button_interrupt_init();
-    __delay_ms(500);
+
+    /* Warm restart : display is powered, no waits (see supervisor.h) */
+    if(cause == RESET_COLD)
+    {
+        clock_delay_ms(500);
+    }
     
-    oled_lcd_init();
+    PERF_BEGIN(PERF_LCD_INIT);
+    oled_lcd_init(cause == RESET_COLD);
+    PERF_END(PERF_LCD_INIT);
+    language_init(font_init());
 
     /* Go to Graphic mode */
+    PERF_BEGIN(PERF_GRAPHIC_MODE);
     goto_graphic_mode();
-    __delay_ms(1000);
-    
-    /* Write Default Message */
-    write_default_message();
-    
+    PERF_END(PERF_GRAPHIC_MODE);
+    if(cause == RESET_COLD)
+    {
+        clock_delay_ms(1000);
+    }
+
+    /* Write Default Message, or the screen and timers before the restart */
+    call_state = CALL_IDLE;
+    if(cause == RESET_COLD)
+    {
+        show_screen(SCREEN_DEFAULT);
+        call_save(0);
+    }
+    else
+    {
+        call_restore(&warm);
+    }
+
+    /* Display which fails again right after init is left (calls still work) */
+    display_ok = !oled_bus_fault();
+    supervisor_start();
+
     while(1)
     {
-        ;
+        supervisor_kick();
+
+        /* Display stopped responding : warm restart reinitializes it */
+        if(display_ok && oled_bus_fault())
+        {
+            supervisor_restart();
+        }
+
+        /* Presses during the call are merged or queued by call_press() */
+        if((call_state == CALL_IDLE) && call_start(&call_button))
+        {
+            PERF_BEGIN(PERF_CALL_SEQUENCE);
+            call_state = CALL_DEBOUNCE;
+            timer_start(TIMER_DEBOUNCE, TIMER_TICKS(CALL_DEBOUNCE_MS));
+            call_save(0);
+        }
+
+        /* Bluetooth link (AT commands, STATE pin) and Heartbeat */
+        bt_task();
+        link_task();
+
+        call_sequence();
+
+        /* Screen wipe, scroll of message wider than the display, wait indicator */
+        transition_task();
+        marquee_task();
+        anim_task();
+
+        /* Responce is taken by call_sequence() while waiting, AT reply by bt_task() */
+        if((call_state != CALL_WAIT) && !bt_command_mode() && usart_receive(&receive_data))
+        {
+            if(link_receive(receive_data) == 0)
+            {
+                command_sequence(receive_data);
+            }
+        }
+
+        /* Write Call Journal in background */
+        journal_task();
     }
     
     return 0;
@@ -82,71 +265,388 @@ static void pic_port_init(void)
  *----------------------------------------------------*/
 static void interrupt isr(void)
 {
-    unsigned char counter = 0;
-    
-    /* Button0(RB0) Interrupt */
-    if(IOCBF0)
+    PERF_BEGIN(PERF_ISR);
+
+    /* USART RX, System Tick, Button0(RB0), Cycle Counter : see irq.h */
+    irq_dispatch();
+
+    PERF_END(PERF_ISR);
+}
+
+
+/*-----------------------------------------------------
+ * Call Sequence (called from main loop, never waits)
+ *---------------------------------------------------*/
+static void call_sequence(void)
+{
+    uint8_t id;
+    uint32_t latency_tick;
+    const responce_desc_t *p_desc;
+    journal_outcome_t outcome;
+
+    switch(call_state)
     {
-        /* Prevent a chattering */
-        __delay_ms(100);
+        case CALL_DEBOUNCE:
+            if(timer_expired(TIMER_DEBOUNCE))
+            {
+                latency_mark(LATENCY_DEBOUNCE);
+                chime_play(CHIME_PRESS);
+                call_notify();
+            }
+            break;
 
-        /* Write Call Message */
-        write_call_message();
+        case CALL_WAIT:
+            /* Other bytes than Responce are noise */
+            if(!bt_command_mode() && receive_responce(&id))
+            {
+                timer_stop(TIMER_RESPONCE);
+                latency_tick = systick_get() - notify_tick;
+                p_desc = responce_get(id);
+                chime_play((chime_melody_t)p_desc->chime);
+                receive_sequence(id);
+                outcome = (id == RESPONCE1) ? JOURNAL_RESPONCE1 :
+                          (id == RESPONCE2) ? JOURNAL_RESPONCE2 : JOURNAL_OTHER;
+                journal_record(notify_tick, outcome, latency_tick);
+                call_hold(p_desc->hold_ticks);
+            }
+            else if(timer_expired(TIMER_RESPONCE) || !link_is_up())
+            {
+                /* Responce timeout or Handset lost, Write Not Here Message */
+                timer_stop(TIMER_RESPONCE);
+                latency_tick = systick_get() - notify_tick;
+                journal_record(notify_tick, JOURNAL_TIMEOUT, latency_tick);
+                chime_play(CHIME_NOT_HERE);
+
+                show_screen(SCREEN_NOT_HERE);
+                call_hold(TIMER_TICKS(CALL_HOLD_MS));
+            }
+            else if(timer_expired(TIMER_CALL_UPDATE))
+            {
+                call_update();
+            }
+            break;
 
-        /* Transmit Notification via Bluetooth */
-        put_char(0x01);
+        case CALL_HOLD:
+            if(timer_expired(TIMER_HOLD) || call_pending())
+            {
+                timer_stop(TIMER_HOLD);
+                call_finish();
+
+                /* Return display to Default Message, unless next call is drawn */
+                if(call_pending() == 0)
+                {
+                    show_screen(SCREEN_DEFAULT);
+                }
+
+                call_state = CALL_IDLE;
+                call_save(0);
+                latency_clear();
+                PERF_END(PERF_CALL_SEQUENCE);
+            }
+            break;
 
-        /* Wait for 20[s] or to receive Responce */
-        while(counter < 40)
+        default:
+            break;
+    }
+}
+
+
+/*-----------------------------------------------------
+ * Notify Call and Write Call Message
+ *---------------------------------------------------*/
+static void call_notify(void)
+{
+    uint16_t responce_ticks = 0;
+
+    /* Transmit Notification via Bluetooth (or Multi-drop bus) before redraw */
+    notify_tick = systick_get();
+    if(!link_is_up())
+    {
+        /* Handset is known to be lost, time out at next tick (and check again) */
+        link_probe();
+    }
+    else
+    {
+        usart_rx_flush();
+        /* Handset did not receive : time out at next tick */
+        if(usart_notify(PROTOCOL_CALL))
         {
-            if(RCIF)
+            responce_ticks = TIMER_TICKS(CALL_RESPONCE_MS);
+        }
+        usart_wait_idle();
+
+        /* Handset out of range is found within LINK_MISS_MAX x RTO */
+        link_probe();
+    }
+    timer_start(TIMER_RESPONCE, responce_ticks);
+    latency_mark(LATENCY_NOTIFY);
+    timer_start(TIMER_CALL_UPDATE, TIMER_TICKS(CALL_UPDATE_MS));
+
+    /* Write Call Message (Responce during redraw is buffered) */
+    show_screen(SCREEN_CALL);
+    latency_mark(LATENCY_DISPLAY);
+
+    /* Spinner and time left until TIMER_RESPONCE */
+    anim_play(ANIM_WAIT_SPINNER, &anim_spinner, WAIT_SPINNER_X, WAIT_SPINNER_LINE);
+    anim_countdown(ANIM_WAIT_PROGRESS, 0, WAIT_PROGRESS_LINE, MARQUEE_WIDTH, TIMER_TICKS(CALL_RESPONCE_MS));
+
+    call_state = CALL_WAIT;
+    call_save(responce_ticks);
+}
+
+
+/*-----------------------------------------------------
+ * Hold Message on the display for ticks
+ *---------------------------------------------------*/
+static void call_hold(uint16_t ticks)
+{
+    anim_stop();
+    timer_stop(TIMER_CALL_UPDATE);
+    timer_start(TIMER_HOLD, ticks);
+    call_state = CALL_HOLD;
+    call_save(ticks);
+}
+
+
+/*-----------------------------------------------------
+ * Send Press Count of Repeat Presses (1 frame per CALL_UPDATE_MS at most)
+ *---------------------------------------------------*/
+static void call_update(void)
+{
+    uint8_t presses;
+
+    if(link_is_up() && call_take_update(&presses))
+    {
+        /* 1 frame of 3 bytes (usart_send_frame() is a frame of its own) */
+        usart_begin_frame();
+        put_char(PROTOCOL_CALL_UPDATE);
+        put_char(call_button);
+        put_char(presses);
+        usart_end_frame();
+    }
+    timer_start(TIMER_CALL_UPDATE, TIMER_TICKS(CALL_UPDATE_MS));
+}
+
+
+/*-----------------------------------------------------
+ * Command Sequence (Request from Handset, except while waiting for Responce)
+ *---------------------------------------------------*/
+static void command_sequence(uint8_t receive_data)
+{
+    switch(receive_data)
+    {
+        case PROTOCOL_JOURNAL_READ:
+            clock_set_mode(CLOCK_MODE_FULL);
+            PERF_BEGIN(PERF_JOURNAL_DUMP);
+            journal_dump();
+            PERF_END(PERF_JOURNAL_DUMP);
+            clock_set_mode(CLOCK_MODE_IDLE);
+            break;
+
+        case PROTOCOL_LATENCY_READ:
+            clock_set_mode(CLOCK_MODE_FULL);
+            latency_dump();
+            clock_set_mode(CLOCK_MODE_IDLE);
+            break;
+
+#if PERF_ENABLE
+        case PROTOCOL_PERF_READ:
+            clock_set_mode(CLOCK_MODE_FULL);
+            perf_dump();
+            clock_set_mode(CLOCK_MODE_IDLE);
+            break;
+#endif
+
+#if !USART_MULTIDROP
+        case PROTOCOL_BOOT:
+            if(!boot_key_received())
             {
-                receive_sequence();
-                break;                
+                break;
             }
-            __delay_ms(500);
-            counter++;
+            usart_wait_idle();
+            chime_stop();
+            supervisor_invalidate();    // New application starts cold
+            boot_main();    // Never returns
+            break;
+#endif
+
+        default:
+            /* Select Language : pack is swapped, screen is redrawn */
+            if((uint8_t)(receive_data - PROTOCOL_LANGUAGE_BASE) < PROTOCOL_LANGUAGE_MAX)
+            {
+                if(language_select((uint8_t)(receive_data - PROTOCOL_LANGUAGE_BASE)))
+                {
+                    show_screen(screen);
+                    usart_send_frame(receive_data);
+                }
+            }
+            break;
+    }
+}
+
+
+/*-----------------------------------------------------
+ * Receive Sequence (message of the Responce : responce.h)
+ *---------------------------------------------------*/
+static void receive_sequence(uint8_t id)
+{
+    show_screen((uint8_t)(SCREEN_RESPONCE + id));
+    usart_send_frame(PROTOCOL_SHOWN);
+}
+
+
+/*-----------------------------------------------------
+ * Receive Responce from Handset
+ *   Drains the receive buffer, so that a burst of noise
+ *   cannot fill it up and push out the Responce.
+ *   Returns 1 if a Responce is received (*p_id : id).
+ *   A Responce that cannot be shown is dropped.
+ *---------------------------------------------------*/
+static uint8_t receive_responce(uint8_t *p_id)
+{
+    uint8_t data;
+
+    while(usart_receive(&data))
+    {
+        if(link_receive(data))
+        {
+            continue;
         }
+        *p_id = responce_find(data);
 
-        /* If Responce timeout , Write Not Here Message */
-        if(counter == 40)
+        /* No SHOWN for a message that would be blank (no font) */
+        if((*p_id != RESPONCE_NONE) && language_can_show((uint8_t)(MESSAGE_RESPONCE + *p_id)))
         {
-            write_not_here_message();
-            __delay_ms(10000);
-            __delay_ms(10000);
+            return 1;
         }
-        
-        /* Clear Flag */
-        IOCBF            = 0x00;
-        INTCONbits.IOCIF = 0;   
-
-        /* Return display to Default Message */
-    	write_default_message();
-    }    
+    }
+
+    return 0;
 }
 
 
 /*-----------------------------------------------------
- * Receive Sequence
+ * Write Screen (kept for a warm restart)
+ *   next : screen_t, or SCREEN_RESPONCE + Responce id
  *---------------------------------------------------*/
-static void receive_sequence(void)
+static void show_screen(uint8_t next)
 {
-    unsigned char receive_data;
-    
-    receive_data = RCREG;
+    clock_set_mode(CLOCK_MODE_FAST);
+    switch(next)
+    {
+        case SCREEN_CALL:
+            write_call_message();
+            break;
 
-    switch(receive_data)
+        case SCREEN_NOT_HERE:
+            write_not_here_message();
+            break;
+
+        case SCREEN_DEFAULT:
+            write_default_message();
+            break;
+
+        default:
+            write_responce_message((uint8_t)(next - SCREEN_RESPONCE));
+            break;
+    }
+    clock_set_mode(CLOCK_MODE_IDLE);
+
+    screen = next;
+}
+
+
+/*-----------------------------------------------------
+ * Save Call State for a warm restart
+ *   ticks : time until the state times out (0 : none)
+ *---------------------------------------------------*/
+static void call_save(uint16_t ticks)
+{
+    warm_state_t state;
+
+    state.call_state  = call_state;
+    state.call_button = call_button;
+    state.screen      = screen;
+    state.notify_tick = notify_tick;
+    state.deadline    = systick_get() + ticks;
+
+    supervisor_save(&state);
+}
+
+
+/*-----------------------------------------------------
+ * Restore Call State after a warm restart
+ *   Timers run for the time left before the restart.
+ *   A call being debounced is queued again in main().
+ *---------------------------------------------------*/
+static void call_restore(const warm_state_t *p_warm)
+{
+    uint32_t now = systick_get();
+    uint16_t left = 0;
+
+    call_button = p_warm->call_button;
+    notify_tick = p_warm->notify_tick;
+    if((int32_t)(p_warm->deadline - now) > 0)
+    {
+        left = (uint16_t)(p_warm->deadline - now);
+    }
+
+    switch(p_warm->call_state)
     {
-        case 1: 
-            write_responce_message(RESPONCE1);
-            __delay_ms(10000);
-            __delay_ms(10000);
+        case CALL_WAIT:
+            PERF_BEGIN(PERF_CALL_SEQUENCE);
+            show_screen(SCREEN_CALL);
+            timer_start(TIMER_RESPONCE, left);
+            timer_start(TIMER_CALL_UPDATE, TIMER_TICKS(CALL_UPDATE_MS));
+            anim_play(ANIM_WAIT_SPINNER, &anim_spinner, WAIT_SPINNER_X, WAIT_SPINNER_LINE);
+            anim_countdown(ANIM_WAIT_PROGRESS, 0, WAIT_PROGRESS_LINE,
+                           (uint8_t)((uint32_t)MARQUEE_WIDTH * left / TIMER_TICKS(CALL_RESPONCE_MS)), left);
+            call_state = CALL_WAIT;
+            break;
+
+        case CALL_HOLD:
+            PERF_BEGIN(PERF_CALL_SEQUENCE);
+            show_screen(p_warm->screen);
+            timer_start(TIMER_HOLD, left);
+            call_state = CALL_HOLD;
             break;
-                        
-        case 2:
-            write_responce_message(RESPONCE2);
-            __delay_ms(10000);
-            __delay_ms(10000);
+
+        default:
+            show_screen(SCREEN_DEFAULT);
             break;
     }
+
+    call_save(left);
+}
+
+
+#if !USART_MULTIDROP
+/*-----------------------------------------------------
+ * Receive KEY, ~KEY after PROTOCOL_BOOT
+ *   Each byte must come within PROTOCOL_BOOT_KEY_MS.
+ *   Other bytes are dropped, as a line noise.
+ *---------------------------------------------------*/
+static uint8_t boot_key_received(void)
+{
+    uint8_t expect[2] = {PROTOCOL_BOOT_KEY, (uint8_t)~PROTOCOL_BOOT_KEY};
+    uint8_t i, ms, data;
+
+    for(i = 0; i < 2; i++)
+    {
+        for(ms = 0; usart_receive(&data) == 0; ms++)
+        {
+            if(ms >= PROTOCOL_BOOT_KEY_MS)
+            {
+                return 0;
+            }
+            clock_delay_ms(1);
+        }
+        if(data != expect[i])
+        {
+            return 0;
+        }
+    }
+
+    return 1;
 }
+#endif
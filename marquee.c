@@ -0,0 +1,193 @@
+#include <xc.h>
+#include "marquee.h"
+#include "oled_lcd_lib.h"
+#include "pic_clock.h"
+#include "timer_wheel.h"
+#include "perf.h"
+
+
+/* Prototype of Static Function */
+static uint8_t column(uint16_t index);
+static void step(void);
+
+
+/* Marquee */
+static const uint8_t *p_message;
+static uint8_t  message_len;
+static uint8_t  x_start;            // x address of the left end
+static uint8_t  y_command;          // Set y address command
+static uint8_t  width;              // Visible columns from x_start
+static uint16_t offset;             // Message column at the left end
+static uint8_t  active;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Marquee
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void marquee_init(void)
+{
+    active = 0;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Write Graphic to LCD (Scroll if wider than LCD)
+ * @param
+ *     p_param:pointer to write graphic parameter
+ * @return
+ *     none:
+ * @note
+ *     Message fitting in MARQUEE_WIDTH is written by
+ *     lcd_write_graphic() as before.
+ *     Previous marquee is stopped.
+ *     p_message_buf must stay valid (const in flash)
+ *===================================================*/
+void marquee_show(const write_graphic_param_t *p_param)
+{
+    write_graphic_param_t window;
+
+    marquee_stop();
+
+    x_start = (uint8_t)(p_param->x_axis_address & 0x7F);
+    width   = (uint8_t)(MARQUEE_WIDTH - x_start);
+    if(p_param->message_len <= width)
+    {
+        lcd_write_graphic(p_param);
+        return;
+    }
+
+    p_message   = p_param->p_message_buf;
+    message_len = p_param->message_len;
+    y_command   = p_param->y_axis_address;
+    offset      = 0;
+
+    /* First window is written in one transfer */
+    window             = *p_param;
+    window.message_len = width;
+    lcd_write_graphic(&window);
+
+    active = 1;
+    timer_start(TIMER_DISPLAY, TIMER_TICKS(MARQUEE_PAUSE_MS));
+}
+
+
+/*=====================================================
+ * @brief
+ *     Stop Marquee
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Display is left as it is
+ *===================================================*/
+void marquee_stop(void)
+{
+    timer_stop(TIMER_DISPLAY);
+    active = 0;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Marquee Task (called from main loop)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Scrolls 1 column at each TIMER_DISPLAY expiration
+ *===================================================*/
+void marquee_task(void)
+{
+    if((active == 0) || (timer_expired(TIMER_DISPLAY) == 0))
+    {
+        return;
+    }
+    timer_start(TIMER_DISPLAY, TIMER_TICKS(MARQUEE_STEP_MS));
+
+    clock_set_mode(CLOCK_MODE_FAST);
+    PERF_BEGIN(PERF_MARQUEE_STEP);
+    step();
+    PERF_END(PERF_MARQUEE_STEP);
+    clock_set_mode(CLOCK_MODE_IDLE);
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Column Data of the Marquee
+ * @param
+ *     index:column (0 - message_len + MARQUEE_GAP - 1)
+ * @return
+ *     graphic data (GAP is blank)
+ * @note
+ *     none
+ *---------------------------------------------------*/
+static uint8_t column(uint16_t index)
+{
+    return (index < message_len) ? p_message[index] : 0x00;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Scroll 1 Column
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Column x shows column(offset + x). Only columns
+ *     different from the previous step are written,
+ *     x address is set again after unchanged columns
+ *---------------------------------------------------*/
+static void step(void)
+{
+    uint16_t period = (uint16_t)message_len + MARQUEE_GAP;
+    uint16_t old_index;
+    uint16_t new_index;
+    uint8_t  data;
+    uint8_t  bus_x;             // x address incremented by LCD, 0xFF : not set
+    uint8_t  x;
+
+    old_index = offset;
+    if(++offset == period)
+    {
+        offset = 0;
+    }
+    new_index = offset;
+
+    bus_x = 0xFF;
+    for(x = 0; x < width; x++)
+    {
+        data = column(new_index);
+        if(data != column(old_index))
+        {
+            if(bus_x == 0xFF)
+            {
+                lcd_write(y_command, WRITE_COMMAND_REG);
+            }
+            if(bus_x != x)
+            {
+                lcd_write((uint8_t)(0b10000000 | (x_start + x)), WRITE_COMMAND_REG);
+            }
+            lcd_write(data, WRITE_DATA_REG);
+            bus_x = (uint8_t)(x + 1);
+        }
+
+        old_index = new_index;
+        if(++new_index == period)
+        {
+            new_index = 0;
+        }
+    }
+}
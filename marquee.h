@@ -0,0 +1,82 @@
+#ifndef _MARQUEE_H
+#define _MARQUEE_H
+
+#include <xc.h>
+#include <stdint.h>
+#include "oled_lcd_lib.h"
+
+
+/* Marquee (message wider than the panel) */
+/*---------------------------------------------------
+ Graphic mode has no display shift and no columns out
+ of the 100 visible ones, so the message is scrolled
+ by software. A step moves the message 1 column to
+ the left and writes only the columns whose data
+ changes, blank columns of the bitmap are not sent.
+
+ | <---------- MARQUEE_WIDTH ----------> |
+ | message ...                  | GAP  | message ...
+---------------------------------------------------*/
+#define MARQUEE_WIDTH       (100)   // Visible columns of graphic mode
+#define MARQUEE_GAP         (24)    // Blank columns between end and start
+#define MARQUEE_STEP_MS     (50)    // 20 columns/s
+#define MARQUEE_PAUSE_MS    (1500)  // Start of the message is shown first
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Marquee
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void marquee_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Write Graphic to LCD (Scroll if wider than LCD)
+ * @param
+ *     p_param:pointer to write graphic parameter
+ * @return
+ *     none:
+ * @note
+ *     Message fitting in MARQUEE_WIDTH is written by
+ *     lcd_write_graphic() as before.
+ *     Previous marquee is stopped.
+ *     p_message_buf must stay valid (const in flash)
+ *===================================================*/
+void marquee_show(const write_graphic_param_t *p_param);
+
+
+/*=====================================================
+ * @brief
+ *     Stop Marquee
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Display is left as it is
+ *===================================================*/
+void marquee_stop(void);
+
+
+/*=====================================================
+ * @brief
+ *     Marquee Task (called from main loop)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Scrolls 1 column at each TIMER_DISPLAY expiration
+ *===================================================*/
+void marquee_task(void);
+
+
+#endif  /* _MARQUEE_H */
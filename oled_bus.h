@@ -0,0 +1,173 @@
+#ifndef _OLED_BUS_H
+#define _OLED_BUS_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+
+
+/* Display Bus Type */
+#define OLED_BUS_PARALLEL (0)   // 4bit parallel bus (bit-bang on RB1-RB7)
+#define OLED_BUS_SPI      (1)   // MSSP hardware SPI (RC3, RC4, RC5, RA0)
+
+
+/* Select Display Bus (can be overridden by compiler option -DOLED_BUS=1) */
+#ifndef OLED_BUS
+#define OLED_BUS OLED_BUS_PARALLEL
+#endif
+
+
+#if (OLED_BUS == OLED_BUS_PARALLEL)
+
+/* Pin Configuration */
+#define LCD_RS  RB1     // RS Select (Instruction/Data)
+#define LCD_RW  RB2     // R/W Select Read or Write
+#define LCD_EN  RB3     // Make ChipEnable Pulse
+#define LCD_DB4 RB4     // Data bit 4
+#define LCD_DB5 RB5     // Data bit 5
+#define LCD_DB6 RB6     // Data bit 6
+#define LCD_DB7 RB7     // Data bit 7
+
+
+/* Pin I/O Configuration */
+#define LCD_RS_IO  TRISBbits.TRISB1
+#define LCD_RW_IO  TRISBbits.TRISB2
+#define LCD_EN_IO  TRISBbits.TRISB3
+#define LCD_DB4_IO TRISBbits.TRISB4
+#define LCD_DB5_IO TRISBbits.TRISB5
+#define LCD_DB6_IO TRISBbits.TRISB6
+#define LCD_DB7_IO TRISBbits.TRISB7
+
+
+/* Data Pin Configure INPUT */
+#define DATAPIN_CONFIG_INPUT \
+do                           \
+{                            \
+    ANSELBbits.ANSB1 = 0;    \
+    ANSELBbits.ANSB2 = 0;    \
+    ANSELBbits.ANSB3 = 0;    \
+    ANSELBbits.ANSB4 = 0;    \
+    ANSELBbits.ANSB5 = 0;    \
+    LCD_DB4_IO = 1;          \
+    LCD_DB5_IO = 1;          \
+    LCD_DB6_IO = 1;          \
+    LCD_DB7_IO = 1;          \
+} while(0)
+
+
+/* Data Pin Configure OUTPUT */
+#define DATAPIN_CONFIG_OUTPUT \
+do                            \
+{                             \
+    LCD_DB4_IO = 0;           \
+    LCD_DB5_IO = 0;           \
+    LCD_DB6_IO = 0;           \
+    LCD_DB7_IO = 0;           \
+} while(0)
+
+
+/* ChipEnable Pulse */
+#define ENABLE_PULSE \
+do                   \
+{                    \
+    LCD_EN = 1;      \
+    asm("nop");      \
+    asm("nop");      \
+    LCD_EN = 0;      \
+} while(0)
+
+#elif (OLED_BUS == OLED_BUS_SPI)
+
+/* Pin Configuration (SCK:RC3, SDI:RC4, SDO:RC5 are set by spi_init()) */
+#define LCD_CS     RA0    // Chip Select (Active Low)
+#define LCD_CS_IO  TRISAbits.TRISA0
+
+
+/* Serial Frame (10bit : RS R/W D7 ... D0) */
+#define SPI_FRAME_RS   (1 << 9)
+#define SPI_FRAME_RW   (1 << 8)
+#define SPI_FRAME_BITS (10)
+
+#else
+#error "OLED_BUS must be OLED_BUS_PARALLEL or OLED_BUS_SPI"
+#endif
+
+
+/* Busy Flag Timeout (longer than any command, Display Clear : 6.2ms) */
+#define OLED_BUSY_TIMEOUT_MS    (50)
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Display Bus
+ * @param
+ *     power_on:1:Wait for power stabilization (cold
+ *              start), 0:Display is already powered
+ * @return
+ *     none:
+ * @note
+ *     Configure pins, wait for power stabilization,
+ *     synchronize the bus and issue Function Set
+ *     (DL bit depends on the bus).
+ *     Busy fault is cleared
+ *===================================================*/
+void oled_bus_init(uint8_t power_on);
+
+
+/*=====================================================
+ * @brief
+ *     Write Command Register
+ * @param
+ *     command:command transmitted to LCD
+ * @return
+ *     none:
+ * @note
+ *     Wait until the command is executed
+ *===================================================*/
+void oled_bus_command(uint8_t command);
+
+
+/*=====================================================
+ * @brief
+ *     Write Data Register (Burst)
+ * @param
+ *     p_data_buf:pointer to data transmitted to LCD
+ *     data_len  :number of data bytes
+ * @return
+ *     none:
+ * @note
+ *     Address counter is incremented by LCD
+ *===================================================*/
+void oled_bus_data(const uint8_t *p_data_buf, uint8_t data_len);
+
+
+/*=====================================================
+ * @brief
+ *     Read BusyFlag
+ * @param
+ *     none:
+ * @return
+ *     0:Ready, 1:Busy
+ * @note
+ *     none
+ *===================================================*/
+uint8_t oled_bus_busy(void);
+
+
+/*=====================================================
+ * @brief
+ *     Check Display Fault
+ * @param
+ *     none:
+ * @return
+ *     1:BusyFlag stayed set over OLED_BUSY_TIMEOUT_MS
+ * @note
+ *     After a fault, writes do not wait for BusyFlag
+ *     until oled_bus_init()
+ *===================================================*/
+uint8_t oled_bus_fault(void);
+
+
+#endif  /* _OLED_BUS_H */
@@ -0,0 +1,291 @@
+#include <xc.h>
+#include "pic_clock.h"
+#include "oled_bus.h"
+#include "systick.h"
+
+#if (OLED_BUS == OLED_BUS_PARALLEL)
+
+
+/* RS - R/W Function Table */
+/*-------------------------------
+| RS | R/W | Function           |
+---------------------------------
+|  L |  L  | Write Command Reg  |
+---------------------------------
+|  H |  L  | Write Data Reg     |
+---------------------------------
+|  L |  H  | Read Status Reg    |
+---------------------------------
+|  H |  H  | Read Data Reg      |
+-------------------------------*/
+
+
+/* Prototype of Static Function */
+static void lcd_write_byte(uint8_t write_data);
+static void lcd_write_4bit(uint8_t write_data);
+static void lcd_read_4bit(uint8_t *p_read_buf);
+static void check_busy_flag(void);
+
+
+/* BusyFlag Timeout Occurred */
+static uint8_t bus_fault;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Display Bus
+ * @param
+ *     power_on:1:Wait for power stabilization (cold
+ *              start), 0:Display is already powered
+ * @return
+ *     none:
+ * @note
+ *  Function Set
+ *  --------------------------------------------------
+ *  | 0b 0 0 1 DL N F FT1 FT0                        |
+ *  | DL : 0  (4bit mode)                            |
+ *  | N  : 1  (2-line display)                       |
+ *  | F  : 0  (5 * 8dots)                            |
+ *  | FT : 00 (English Japanese character font table)|
+ *  --------------------------------------------------
+ *===================================================*/
+void oled_bus_init(uint8_t power_on)
+{
+    uint8_t i;
+
+    /* Pin I/O configuration -> all OUTPUT */
+    LCD_RS_IO  = 0;
+    LCD_RW_IO  = 0;
+    LCD_EN_IO  = 0;
+    DATAPIN_CONFIG_OUTPUT;
+
+    /* All Data Pin Clear */
+    LCD_RS  = 0;
+    LCD_RW  = 0;
+    LCD_EN  = 0;
+    LCD_DB4 = 0;
+    LCD_DB5 = 0;
+    LCD_DB6 = 0;
+    LCD_DB7 = 0;
+
+    bus_fault = 0;
+
+    /* Wait for Power Stabilization 500ms */
+    if(power_on)
+    {
+        clock_delay_ms(500);
+    }
+
+    /* Synchronization function */
+    for(i = 0; i < 5; i++)
+    {
+        lcd_write_4bit(0x00);
+    }
+
+    /* Function Set */
+    lcd_write_4bit(0b00000010);
+    oled_bus_command(0b00101000);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Write Command Register
+ * @param
+ *     command:command transmitted to LCD
+ * @return
+ *     none:
+ * @note
+ *     Wait until the command is executed
+ *===================================================*/
+void oled_bus_command(uint8_t command)
+{
+    /* Write Command Register */
+    LCD_RW = 0;
+    LCD_RS = 0;
+
+    lcd_write_byte(command);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Write Data Register (Burst)
+ * @param
+ *     p_data_buf:pointer to data transmitted to LCD
+ *     data_len  :number of data bytes
+ * @return
+ *     none:
+ * @note
+ *     Address counter is incremented by LCD
+ *===================================================*/
+void oled_bus_data(const uint8_t *p_data_buf, uint8_t data_len)
+{
+    uint8_t i;
+
+    for(i = 0; i < data_len; i++)
+    {
+        /* Write Data Register (RS is changed by BusyFlag check) */
+        LCD_RW = 0;
+        LCD_RS = 1;
+
+        lcd_write_byte(p_data_buf[i]);
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Read BusyFlag
+ * @param
+ *     none:
+ * @return
+ *     0:Ready, 1:Busy
+ * @note
+ *     none
+ *===================================================*/
+uint8_t oled_bus_busy(void)
+{
+    uint8_t status = 0x00;
+
+    /* Read Status Register */
+    LCD_RW = 1;
+    LCD_RS = 0;
+
+    /* Data pin configure INPUT */
+    DATAPIN_CONFIG_INPUT;
+
+    /* Read data from LCD */
+    lcd_read_4bit(&status);
+    lcd_read_4bit(&status);
+
+    return ((status & 0x80) != 0);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Check Display Fault
+ * @param
+ *     none:
+ * @return
+ *     1:BusyFlag stayed set over OLED_BUSY_TIMEOUT_MS
+ * @note
+ *     After a fault, writes do not wait for BusyFlag
+ *     until oled_bus_init()
+ *===================================================*/
+uint8_t oled_bus_fault(void)
+{
+    return bus_fault;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Write 1 Byte to LCD
+ * @param
+ *     write_data:data transmitted to LCD
+ * @return
+ *     none:
+ * @note
+ *     RS, R/W must be set before calling
+ *---------------------------------------------------*/
+static void lcd_write_byte(uint8_t write_data)
+{
+    /* Data pin configure OUTPUT */
+    DATAPIN_CONFIG_OUTPUT;
+
+    /* Write data to LCD */
+    lcd_write_4bit(write_data >> 4);
+    lcd_write_4bit(write_data);
+
+    /* Check BusyFlag */
+    check_busy_flag();
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Write data to LCD
+ * @param
+ *     write_data:data transmitted to LCD
+ * @return
+ *     none:
+ * @note
+ *     none
+ *---------------------------------------------------*/
+static void lcd_write_4bit(uint8_t write_data)
+{
+    /* Write data to I/O PORT */
+    LCD_DB4 = ((write_data >> 0) & 0x01);
+    LCD_DB5 = ((write_data >> 1) & 0x01);
+    LCD_DB6 = ((write_data >> 2) & 0x01);
+    LCD_DB7 = ((write_data >> 3) & 0x01);
+
+    /* Transmit data to LCD */
+    ENABLE_PULSE;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Read data from LCD
+ * @param
+ *     p_read_buf :pointer to store gotten data
+ * @return
+ *     none:
+ * @note
+ *     none
+ *---------------------------------------------------*/
+static void lcd_read_4bit(uint8_t *p_read_buf)
+{
+    /* Read data */
+    LCD_EN = 1;     // Start receiving data
+
+    (*p_read_buf) <<= 1;
+    *p_read_buf |= LCD_DB7;
+    (*p_read_buf) <<= 1;
+    *p_read_buf |= LCD_DB6;
+    (*p_read_buf) <<= 1;
+    *p_read_buf |= LCD_DB5;
+    (*p_read_buf) <<= 1;
+    *p_read_buf |= LCD_DB4;
+
+    LCD_EN = 0;    // End receiving data
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Check BusyFlag
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Gives up after OLED_BUSY_TIMEOUT_MS and sets
+ *     the fault, so that a display not responding
+ *     cannot hang the Unit
+ *---------------------------------------------------*/
+static void check_busy_flag(void)
+{
+    uint32_t start;
+
+    if(bus_fault)
+    {
+        return;
+    }
+
+    start = systick_get();
+    while(oled_bus_busy())
+    {
+        if((systick_get() - start) > SYSTICK_MS(OLED_BUSY_TIMEOUT_MS))
+        {
+            bus_fault = 1;
+            break;
+        }
+    }
+}
+
+
+#endif  /* OLED_BUS == OLED_BUS_PARALLEL */
@@ -0,0 +1,253 @@
+#include <xc.h>
+#include "pic_clock.h"
+#include "oled_bus.h"
+#include "spi.h"
+#include "systick.h"
+
+#if (OLED_BUS == OLED_BUS_SPI)
+
+
+/* Prototype of Static Function */
+static void spi_put_frame(uint16_t frame);
+static void spi_flush_frame(void);
+static void check_busy_flag(void);
+
+
+/* BusyFlag Timeout Occurred */
+static uint8_t bus_fault;
+
+
+/* Serial Frame Packing Buffer */
+static uint8_t pack_buf;    // Pending bits (LSB aligned)
+static uint8_t pack_bits;   // Number of pending bits (0 - 7)
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Display Bus
+ * @param
+ *     power_on:1:Wait for power stabilization (cold
+ *              start), 0:Display is already powered
+ * @return
+ *     none:
+ * @note
+ *  MSSP SPI Master (spi.c)
+ *  --------------------------------------------------
+ *  | Clock : Fosc/64 (SPI_CLOCK_SLOW)               |
+ *  | CKP   : 1 (Idle High)                          |
+ *  | CKE   : 0 (LCD latches data on rising edge)    |
+ *  --------------------------------------------------
+ *
+ *  Function Set
+ *  --------------------------------------------------
+ *  | 0b 0 0 1 DL N F FT1 FT0                        |
+ *  | DL : 1  (8bit mode / serial)                   |
+ *  | N  : 1  (2-line display)                       |
+ *  | F  : 0  (5 * 8dots)                            |
+ *  | FT : 00 (English Japanese character font table)|
+ *  --------------------------------------------------
+ *===================================================*/
+void oled_bus_init(uint8_t power_on)
+{
+    /* Pin I/O configuration */
+    ANSELAbits.ANSA0 = 0;
+    LCD_CS     = 1;
+    LCD_CS_IO  = 0;
+
+    /* Initialize MSSP */
+    spi_init();
+
+    pack_buf  = 0;
+    pack_bits = 0;
+
+    bus_fault = 0;
+
+    /* Wait for Power Stabilization 500ms */
+    if(power_on)
+    {
+        clock_delay_ms(500);
+    }
+
+    /* Function Set */
+    oled_bus_command(0b00111000);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Write Command Register
+ * @param
+ *     command:command transmitted to LCD
+ * @return
+ *     none:
+ * @note
+ *     Wait until the command is executed
+ *===================================================*/
+void oled_bus_command(uint8_t command)
+{
+    LCD_CS = 0;
+    spi_put_frame(command);
+    spi_flush_frame();
+    LCD_CS = 1;
+
+    check_busy_flag();
+}
+
+
+/*=====================================================
+ * @brief
+ *     Write Data Register (Burst)
+ * @param
+ *     p_data_buf:pointer to data transmitted to LCD
+ *     data_len  :number of data bytes
+ * @return
+ *     none:
+ * @note
+ *     Frames are packed back to back while CS is held
+ *     low, so 4 data bytes cost 5 SPI bytes. At Fosc/64
+ *     a frame takes longer than the data write time,
+ *     so BusyFlag is checked only after the burst.
+ *===================================================*/
+void oled_bus_data(const uint8_t *p_data_buf, uint8_t data_len)
+{
+    uint8_t i;
+
+    LCD_CS = 0;
+    for(i = 0; i < data_len; i++)
+    {
+        spi_put_frame(SPI_FRAME_RS | p_data_buf[i]);
+    }
+    spi_flush_frame();
+    LCD_CS = 1;
+
+    check_busy_flag();
+}
+
+
+/*=====================================================
+ * @brief
+ *     Read BusyFlag
+ * @param
+ *     none:
+ * @return
+ *     0:Ready, 1:Busy
+ * @note
+ *     RS=0, R/W=1 are shifted out, then LCD drives
+ *     D7...D0 on SDI during the following 8 clocks.
+ *===================================================*/
+uint8_t oled_bus_busy(void)
+{
+    uint8_t status;
+
+    LCD_CS = 0;
+    status = spi_transfer(0b01000000);  // RS R/W + D7-D2
+    spi_transfer(0x00);                 // D1-D0 (not used)
+    LCD_CS = 1;
+
+    /* D7 (BusyFlag) is the 3rd bit of the frame */
+    return ((status & 0x20) != 0);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Check Display Fault
+ * @param
+ *     none:
+ * @return
+ *     1:BusyFlag stayed set over OLED_BUSY_TIMEOUT_MS
+ * @note
+ *     After a fault, writes do not wait for BusyFlag
+ *     until oled_bus_init()
+ *===================================================*/
+uint8_t oled_bus_fault(void)
+{
+    return bus_fault;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Pack 10bit Frame into SPI bytes
+ * @param
+ *     frame:RS R/W D7...D0
+ * @return
+ *     none:
+ * @note
+ *     Complete bytes are transmitted immediately,
+ *     the remainder is kept in pack_buf.
+ *---------------------------------------------------*/
+static void spi_put_frame(uint16_t frame)
+{
+    uint8_t head_bits = 8 - pack_bits;
+
+    /* Fill up pending byte with upper bits of frame */
+    spi_transfer((uint8_t)((pack_buf << head_bits) | (frame >> (SPI_FRAME_BITS - head_bits))));
+
+    /* Keep the rest (2 - 9 bits) */
+    pack_bits = SPI_FRAME_BITS - head_bits;
+    if(pack_bits >= 8)
+    {
+        pack_bits -= 8;
+        spi_transfer((uint8_t)(frame >> pack_bits));
+    }
+    pack_buf = (uint8_t)(frame & ((1 << pack_bits) - 1));
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Transmit pending bits of the last Frame
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Padding bits are discarded by LCD at CS rising
+ *---------------------------------------------------*/
+static void spi_flush_frame(void)
+{
+    if(pack_bits != 0)
+    {
+        spi_transfer((uint8_t)(pack_buf << (8 - pack_bits)));
+    }
+
+    pack_buf  = 0;
+    pack_bits = 0;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Check BusyFlag
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Gives up after OLED_BUSY_TIMEOUT_MS and sets
+ *     the fault, so that a display not responding
+ *     cannot hang the Unit
+ *---------------------------------------------------*/
+static void check_busy_flag(void)
+{
+    uint32_t start;
+
+    if(bus_fault)
+    {
+        return;
+    }
+
+    start = systick_get();
+    while(oled_bus_busy())
+    {
+        if((systick_get() - start) > SYSTICK_MS(OLED_BUSY_TIMEOUT_MS))
+        {
+            bus_fault = 1;
+            break;
+        }
+    }
+}
+
+
+#endif  /* OLED_BUS == OLED_BUS_SPI */
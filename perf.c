@@ -0,0 +1,352 @@
+#include <xc.h>
+#include "perf.h"
+#include "usart.h"
+#include "link.h"
+#include "font.h"
+#include "pool.h"
+#include "irq.h"
+#include "supervisor.h"
+
+#if PERF_ENABLE
+
+
+/* Prototype of Static Function */
+static void put_text(const char *p_text);
+static void put_number(uint32_t value);
+
+
+/* Statistics of each Probe */
+typedef struct
+{
+    uint32_t start;
+    uint32_t last;
+    uint32_t min;
+    uint32_t max;
+    uint16_t count;
+} perf_stat_t;
+
+
+/* Probe Name (same order as perf_probe_t) */
+static const char * const probe_name[PERF_PROBE_NUM] =
+{
+    "lcd_init",
+    "graphic_mode",
+    "default_message",
+    "call_message",
+    "not_here_message",
+    "responce_message",
+    "journal_dump",
+    "call_sequence",
+    "marquee_step",
+    "anim_frame",
+    "transition_step",
+    "wdt_kick",
+    "isr",
+};
+
+
+static perf_stat_t perf_stat[PERF_PROBE_NUM];
+static volatile uint16_t overflow_count;    // Upper 16bit of cycle counter
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Cycle Counter (Timer1)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Interrupt is enabled by button_interrupt_init()
+ *     (GIE, PEIE)
+ *===================================================*/
+void perf_init(void)
+{
+    uint8_t i;
+
+    for(i = 0; i < PERF_PROBE_NUM; i++)
+    {
+        perf_stat[i].count = 0;
+    }
+    overflow_count = 0;
+
+    T1CON = (T1CON_TMR1CS_FOSC4 | T1CON_T1CKPS_1);
+    TMR1H = 0;
+    TMR1L = 0;
+    T1CON |= T1CON_TMR1ON;
+
+    /* Enable Timer1 Interrupt */
+    PIR1bits.TMR1IF = 0;
+    PIE1bits.TMR1IE = 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Timer1 Overflow Interrupt
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called by irq_dispatch() when TMR1IF is set
+ *===================================================*/
+void perf_isr(void)
+{
+    overflow_count++;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Cycle Counter
+ * @param
+ *     none:
+ * @return
+ *     instruction cycles since perf_init()
+ * @note
+ *     Cycles are Fosc/4 of the current clock mode, so
+ *     a clock_set_mode() inside a probe changes the
+ *     rate of counting
+ *===================================================*/
+uint32_t perf_now(void)
+{
+    uint8_t high;
+    uint8_t low;
+    uint16_t upper;
+    uint8_t tmr1ie;
+
+    tmr1ie = PIE1bits.TMR1IE;
+    PIE1bits.TMR1IE = 0;
+
+    /* TMR1L may carry into TMR1H between the reads */
+    do
+    {
+        high = TMR1H;
+        low  = TMR1L;
+    } while(high != TMR1H);
+
+    /* Overflow not yet counted by isr() */
+    upper = overflow_count;
+    if(PIR1bits.TMR1IF && (high < 0x80))
+    {
+        upper++;
+    }
+
+    PIE1bits.TMR1IE = tmr1ie;
+
+    return ((uint32_t)upper << 16) | ((uint16_t)high << 8) | low;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Start Probe
+ * @param
+ *     probe:probe to start
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void perf_begin(perf_probe_t probe)
+{
+    perf_stat[probe].start = perf_now();
+}
+
+
+/*=====================================================
+ * @brief
+ *     Stop Probe and update Statistics
+ * @param
+ *     probe:probe to stop
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void perf_end(perf_probe_t probe)
+{
+    perf_stat_t *p_stat = &perf_stat[probe];
+    uint32_t cycle;
+
+    cycle = perf_now() - p_stat->start;
+
+    p_stat->last = cycle;
+    if((p_stat->count == 0) || (cycle < p_stat->min))
+    {
+        p_stat->min = cycle;
+    }
+    if((p_stat->count == 0) || (cycle > p_stat->max))
+    {
+        p_stat->max = cycle;
+    }
+    if(p_stat->count < 0xFFFF)
+    {
+        p_stat->count++;
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Transmit Statistics as JSON via USART
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *  Response to PROTOCOL_PERF_READ
+ *  --------------------------------------------------
+ *  | PROTOCOL_PERF_READ                             |
+ *  | JSON text (1 line, '\n' end)                   |
+ *  |  {"unit":"cycle","probe":[                     |
+ *  |   {"name":"lcd_init","n":1,"last":..,          |
+ *  |    "min":..,"max":..},...],"usart":{..},       |
+ *  |  "link":{"srtt_ms":..,"rto_ms":..,"lost":..},  |
+ *  |  "font":{"hit":..,"miss":..},                  |
+ *  |  "pool":[{"size":8,"num":8,"used":..,          |
+ *  |    "peak":..,"fail":..},...],                  |
+ *  |  "irq":{"rx_wait_max":..,"source":[            |
+ *  |   {"name":"usart_rx","n":..,"max":..},...]},   |
+ *  |  "restarts":..}                                |
+ *  --------------------------------------------------
+ *===================================================*/
+void perf_dump(void)
+{
+    const volatile usart_rx_stats_t *p_rx = usart_get_rx_stats();
+    const pool_stats_t *p_pool;
+    irq_stats_t irq;
+    perf_stat_t stat;
+    uint8_t i;
+
+    usart_begin_frame();
+    put_char(PROTOCOL_PERF_READ);
+    put_text("{\"unit\":\"cycle\",\"probe\":[");
+    for(i = 0; i < PERF_PROBE_NUM; i++)
+    {
+        supervisor_kick();
+
+        /* ISR probe is updated by interrupt */
+        di();
+        stat = perf_stat[i];
+        ei();
+
+        put_text((i == 0) ? "{\"name\":\"" : ",{\"name\":\"");
+        put_text(probe_name[i]);
+        put_text("\",\"n\":");
+        put_number(stat.count);
+        put_text(",\"last\":");
+        put_number(stat.last);
+        put_text(",\"min\":");
+        put_number(stat.min);
+        put_text(",\"max\":");
+        put_number(stat.max);
+        put_char('}');
+    }
+
+    supervisor_kick();
+    put_text("],\"usart\":{\"overrun\":");
+    put_number(p_rx->overrun);
+    put_text(",\"framing\":");
+    put_number(p_rx->framing);
+    put_text(",\"dropped\":");
+    put_number(p_rx->dropped);
+    put_text("},\"link\":{\"srtt_ms\":");
+    put_number(link_get_srtt());
+    put_text(",\"rto_ms\":");
+    put_number(link_get_rto());
+    put_text(",\"lost\":");
+    put_number(link_get_lost());
+    put_text("},\"font\":{\"hit\":");
+    put_number(font_get_stats()->hit);
+    put_text(",\"miss\":");
+    put_number(font_get_stats()->miss);
+    put_text("},\"pool\":[");
+    for(i = 0; i < POOL_CLASS_NUM; i++)
+    {
+        supervisor_kick();
+        p_pool = pool_get_stats(i);
+        put_text((i == 0) ? "{\"size\":" : ",{\"size\":");
+        put_number(pool_get_size(i));
+        put_text(",\"num\":");
+        put_number(pool_get_num(i));
+        put_text(",\"used\":");
+        put_number(p_pool->used);
+        put_text(",\"peak\":");
+        put_number(p_pool->peak);
+        put_text(",\"fail\":");
+        put_number(p_pool->fail);
+        put_char('}');
+    }
+    put_text("],\"irq\":{\"rx_wait_max\":");
+    put_number(irq_get_rx_wait_max());
+    put_text(",\"source\":[");
+    for(i = 0; i < IRQ_SOURCE_NUM; i++)
+    {
+        supervisor_kick();
+        irq = irq_get_stats(i);
+        put_text((i == 0) ? "{\"name\":\"" : ",{\"name\":\"");
+        put_text(irq_get_name(i));
+        put_text("\",\"n\":");
+        put_number(irq.count);
+        put_text(",\"max\":");
+        put_number(irq.max);
+        put_char('}');
+    }
+    put_text("]},\"restarts\":");
+    put_number(supervisor_get_restarts());
+    put_text("}\n");
+    usart_end_frame();
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Transmit String without terminator
+ * @param
+ *     p_text:string
+ * @return
+ *     none:
+ * @note
+ *     put_string() also transmits '\0'
+ *---------------------------------------------------*/
+static void put_text(const char *p_text)
+{
+    while(*p_text != '\0')
+    {
+        put_char(*p_text);
+        p_text++;
+    }
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Transmit Number in Decimal
+ * @param
+ *     value:number to transmit
+ * @return
+ *     none:
+ * @note
+ *     none
+ *---------------------------------------------------*/
+static void put_number(uint32_t value)
+{
+    char digit[10];
+    uint8_t len = 0;
+
+    do
+    {
+        digit[len++] = (char)('0' + (value % 10));
+        value /= 10;
+    } while(value != 0);
+
+    while(len != 0)
+    {
+        put_char(digit[--len]);
+    }
+}
+
+
+#endif  /* PERF_ENABLE */
@@ -0,0 +1,151 @@
+#ifndef _PERF_H
+#define _PERF_H
+
+#include <xc.h>
+#include <stdint.h>
+
+
+/* Enable Cycle Counters (can be overridden by compiler option -DPERF_ENABLE=1) */
+/*---------------------------------------------------
+| 0 | Probes are removed, Timer1 is not used        |
+-----------------------------------------------------
+| 1 | Timer1 counts instruction cycles (Fosc/4),    |
+|   | results are read by PROTOCOL_PERF_READ        |
+---------------------------------------------------*/
+#ifndef PERF_ENABLE
+#define PERF_ENABLE (0)
+#endif
+
+
+/* Probe */
+typedef enum
+{
+    PERF_LCD_INIT,
+    PERF_GRAPHIC_MODE,
+    PERF_DEFAULT_MESSAGE,
+    PERF_CALL_MESSAGE,
+    PERF_NOT_HERE_MESSAGE,
+    PERF_RESPONCE_MESSAGE,
+    PERF_JOURNAL_DUMP,
+    PERF_CALL_SEQUENCE,
+    PERF_MARQUEE_STEP,
+    PERF_ANIM_FRAME,
+    PERF_TRANSITION_STEP,
+    PERF_WDT_KICK,              // Between kicks (tools/restart_model.c)
+    PERF_ISR,
+    PERF_PROBE_NUM,
+} perf_probe_t;
+
+
+/* T1CON Register Mask */
+#define T1CON_TMR1ON        (1 << 0)
+#define T1CON_T1CKPS_1      (0b00 << 4)
+#define T1CON_TMR1CS_FOSC4  (0b00 << 6)
+
+
+#if PERF_ENABLE
+#define PERF_BEGIN(probe)   perf_begin(probe)
+#define PERF_END(probe)     perf_end(probe)
+#else
+#define PERF_BEGIN(probe)
+#define PERF_END(probe)
+#endif
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Cycle Counter (Timer1)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Interrupt is enabled by button_interrupt_init()
+ *     (GIE, PEIE)
+ *===================================================*/
+void perf_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Timer1 Overflow Interrupt
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called by irq_dispatch() when TMR1IF is set
+ *===================================================*/
+void perf_isr(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get Cycle Counter
+ * @param
+ *     none:
+ * @return
+ *     instruction cycles since perf_init()
+ * @note
+ *     Cycles are Fosc/4 of the current clock mode, so
+ *     a clock_set_mode() inside a probe changes the
+ *     rate of counting
+ *===================================================*/
+uint32_t perf_now(void);
+
+
+/*=====================================================
+ * @brief
+ *     Start Probe
+ * @param
+ *     probe:probe to start
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void perf_begin(perf_probe_t probe);
+
+
+/*=====================================================
+ * @brief
+ *     Stop Probe and update Statistics
+ * @param
+ *     probe:probe to stop
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void perf_end(perf_probe_t probe);
+
+
+/*=====================================================
+ * @brief
+ *     Transmit Statistics as JSON via USART
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *  Response to PROTOCOL_PERF_READ
+ *  --------------------------------------------------
+ *  | PROTOCOL_PERF_READ                             |
+ *  | JSON text (1 line, '\n' end)                   |
+ *  |  {"unit":"cycle","probe":[                     |
+ *  |   {"name":"lcd_init","n":1,"last":..,          |
+ *  |    "min":..,"max":..},...],"usart":{..},       |
+ *  |  "link":{"srtt_ms":..,"rto_ms":..,"lost":..},  |
+ *  |  "font":{"hit":..,"miss":..},                  |
+ *  |  "pool":[{"size":8,"num":8,"used":..,          |
+ *  |    "peak":..,"fail":..},...],                  |
+ *  |  "irq":{"rx_wait_max":..,"source":[            |
+ *  |   {"name":"usart_rx","n":..,"max":..},...]},   |
+ *  |  "restarts":..}                                |
+ *  --------------------------------------------------
+ *===================================================*/
+void perf_dump(void);
+
+
+#endif  /* _PERF_H */
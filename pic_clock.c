@@ -0,0 +1,135 @@
+#include <xc.h>
+#include "pic_clock.h"
+#include "usart.h"
+#include "systick.h"
+#include "chime.h"
+
+
+/* Current Clock Mode */
+static clock_mode_t clock_mode;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Clock
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Start with CLOCK_MODE_FULL (HS selected by CONFIG1)
+ *===================================================*/
+void clock_init(void)
+{
+    OSCCON     = (OSCCON_IRCF_500K | OSCCON_SCS_FOSC);
+    clock_mode = CLOCK_MODE_FULL;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Change System Clock
+ * @param
+ *     mode:clock mode to switch to
+ * @return
+ *     none:
+ * @note
+ *     Wait for an idle USART (TX and RX) and until the
+ *     new oscillator is stable, then reload baudrate
+ *     generator, tick period and pitch
+ *===================================================*/
+void clock_set_mode(clock_mode_t mode)
+{
+    if(mode == clock_mode)
+    {
+        return;
+    }
+
+    /* Do not cut a byte in transmission or in reception
+       (the receiver samples with the old baudrate until the switch) */
+    usart_wait_idle();
+    usart_wait_rx_idle();
+
+    switch(mode)
+    {
+        case CLOCK_MODE_IDLE:
+            OSCCON = (OSCCON_IRCF_500K | OSCCON_SCS_INTOSC);
+            while(OSCSTATbits.MFIOFR == 0)
+            {
+                ;
+            }
+            break;
+
+        case CLOCK_MODE_FULL:
+            OSCCON = (OSCCON_IRCF_500K | OSCCON_SCS_FOSC);
+            while(OSCSTATbits.OSTS == 0)
+            {
+                ;
+            }
+            break;
+
+        case CLOCK_MODE_FAST:
+            OSCCON = (OSCCON_IRCF_16M | OSCCON_SCS_INTOSC);
+            while(OSCSTATbits.HFIOFR == 0)
+            {
+                ;
+            }
+            break;
+    }
+    clock_mode = mode;
+
+    /* Keep Baudrate, Tick Period and Pitch */
+    usart_set_baudrate(mode);
+    systick_set_period(mode);
+    chime_set_mode(mode);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get current Clock Mode
+ * @param
+ *     none:
+ * @return
+ *     current clock mode
+ * @note
+ *     none
+ *===================================================*/
+clock_mode_t clock_get_mode(void)
+{
+    return clock_mode;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Wait [ms] at current Clock Mode
+ * @param
+ *     delay_ms:time to wait [ms]
+ * @return
+ *     none:
+ * @note
+ *     Use this instead of __delay_ms(), which assumes
+ *     _XTAL_FREQ at compile time
+ *===================================================*/
+void clock_delay_ms(uint16_t delay_ms)
+{
+    while(delay_ms > 0)
+    {
+        switch(clock_mode)
+        {
+            case CLOCK_MODE_IDLE:
+                _delay((CLOCK_FREQ_IDLE / 4000) - CLOCK_DELAY_OVERHEAD);
+                break;
+
+            case CLOCK_MODE_FULL:
+                _delay((CLOCK_FREQ_FULL / 4000) - CLOCK_DELAY_OVERHEAD);
+                break;
+
+            case CLOCK_MODE_FAST:
+                _delay((CLOCK_FREQ_FAST / 4000) - CLOCK_DELAY_OVERHEAD);
+                break;
+        }
+        delay_ms--;
+    }
+}
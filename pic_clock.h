@@ -1,10 +1,108 @@
 #ifndef _PIC_CLOCK_H
 #define _PIC_CLOCK_H
 
+#if defined(__XC8)              // Not in host builds (tools/)
 #include <xc.h>
+#endif
+#include <stdint.h>
 
 /* Define Oscillator Frequency -> 10MHz */
 #define _XTAL_FREQ (10000000)
 
 
+/* System Clock Frequency of each Clock Mode */
+#define CLOCK_FREQ_IDLE (500000)        // MFINTOSC 500kHz
+#define CLOCK_FREQ_FULL (_XTAL_FREQ)    // HS Crystal 10MHz
+#define CLOCK_FREQ_FAST (16000000)      // HFINTOSC 16MHz
+
+
+/* OSCCON Register Mask */
+#define OSCCON_SCS_FOSC  (0b00 << 0)    // Clock determined by FOSC (HS)
+#define OSCCON_SCS_INTOSC (0b10 << 0)   // Internal oscillator block
+#define OSCCON_IRCF_500K (0b0111 << 3)
+#define OSCCON_IRCF_16M  (0b1111 << 3)
+#define OSCCON_SPLLEN    (1 << 7)
+
+
+/* Cycles spent by clock_delay_ms() loop itself (per 1ms) */
+#define CLOCK_DELAY_OVERHEAD (12)
+
+
+/* Clock Mode */
+/*---------------------------------------------------
+| Mode | Source   | Freq   | Use                    |
+-----------------------------------------------------
+| IDLE | MFINTOSC | 500kHz | Waiting for button/RX  |
+-----------------------------------------------------
+| FULL | HS       | 10MHz  | Boot, UART bursts      |
+-----------------------------------------------------
+| FAST | HFINTOSC | 16MHz  | Display redraw         |
+-----------------------------------------------------
+ 4x PLL is not used: HS(10MHz) x 4 exceeds 32MHz, and
+ HFINTOSC x 4 requires FOSC = INTOSC configuration.
+---------------------------------------------------*/
+typedef enum
+{
+    CLOCK_MODE_IDLE,
+    CLOCK_MODE_FULL,
+    CLOCK_MODE_FAST,
+} clock_mode_t;
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Clock
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Start with CLOCK_MODE_FULL (HS selected by CONFIG1)
+ *===================================================*/
+void clock_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Change System Clock
+ * @param
+ *     mode:clock mode to switch to
+ * @return
+ *     none:
+ * @note
+ *     Wait for an idle USART (TX and RX) and until the
+ *     new oscillator is stable, then reload baudrate
+ *     generator, tick period and pitch
+ *===================================================*/
+void clock_set_mode(clock_mode_t mode);
+
+
+/*=====================================================
+ * @brief
+ *     Get current Clock Mode
+ * @param
+ *     none:
+ * @return
+ *     current clock mode
+ * @note
+ *     none
+ *===================================================*/
+clock_mode_t clock_get_mode(void);
+
+
+/*=====================================================
+ * @brief
+ *     Wait [ms] at current Clock Mode
+ * @param
+ *     delay_ms:time to wait [ms]
+ * @return
+ *     none:
+ * @note
+ *     Use this instead of __delay_ms(), which assumes
+ *     _XTAL_FREQ at compile time
+ *===================================================*/
+void clock_delay_ms(uint16_t delay_ms);
+
+
 #endif  /* _PIC_CLOCK_H */
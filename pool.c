@@ -0,0 +1,220 @@
+#include <stddef.h>
+#include "pool.h"
+
+
+/* Free List Mark */
+#define POOL_END        (0xFF)      // Last free block
+#define POOL_IN_USE     (0xFE)      // Allocated block
+
+
+/* Class Layout in pool_area */
+typedef struct
+{
+    uint8_t  size;
+    uint8_t  num;
+    uint8_t  first_block;           // Index of free_next
+    uint16_t offset;                // Start in pool_area
+    uint16_t end;                   // offset + size x num
+} pool_class_info_t;
+
+static const pool_class_info_t class_info[POOL_CLASS_NUM] =
+{
+    {POOL_SMALL_SIZE, POOL_SMALL_NUM, 0,
+     0,
+     (POOL_SMALL_SIZE * POOL_SMALL_NUM)},
+    {POOL_FRAME_SIZE, POOL_FRAME_NUM, POOL_SMALL_NUM,
+     (POOL_SMALL_SIZE * POOL_SMALL_NUM),
+     (POOL_SMALL_SIZE * POOL_SMALL_NUM) + (POOL_FRAME_SIZE * POOL_FRAME_NUM)},
+    {POOL_LINE_SIZE,  POOL_LINE_NUM,  POOL_SMALL_NUM + POOL_FRAME_NUM,
+     (POOL_SMALL_SIZE * POOL_SMALL_NUM) + (POOL_FRAME_SIZE * POOL_FRAME_NUM),
+     POOL_AREA_SIZE},
+};
+
+
+/* Pool */
+static uint8_t pool_area[POOL_AREA_SIZE];       // Linear memory
+static volatile uint8_t free_next[POOL_BLOCK_NUM];
+static volatile uint8_t free_head[POOL_CLASS_NUM];
+static volatile pool_stats_t stats[POOL_CLASS_NUM];
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Pool (all blocks free)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void pool_init(void)
+{
+    const pool_class_info_t *p_info;
+    uint8_t c;
+    uint8_t i;
+
+    for(c = 0; c < POOL_CLASS_NUM; c++)
+    {
+        p_info = &class_info[c];
+
+        /* Free list in address order */
+        for(i = 0; i < p_info->num; i++)
+        {
+            free_next[p_info->first_block + i] = (uint8_t)(p_info->first_block + i + 1);
+        }
+        free_next[p_info->first_block + p_info->num - 1] = POOL_END;
+        free_head[c] = p_info->first_block;
+
+        stats[c].used = 0;
+        stats[c].peak = 0;
+        stats[c].fail = 0;
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Allocate Block
+ * @param
+ *     block_class:class of the block
+ * @return
+ *     pointer to the block, NULL:No free block
+ * @note
+ *     O(1), can be called from isr() and main
+ *===================================================*/
+void *pool_alloc(pool_class_t block_class)
+{
+    const pool_class_info_t *p_info = &class_info[block_class];
+    volatile pool_stats_t *p_stats = &stats[block_class];
+    void *p_block = NULL;
+    uint8_t block;
+    uint8_t gie;
+
+    POOL_LOCK(gie);
+
+    block = free_head[block_class];
+    if(block == POOL_END)
+    {
+        if(p_stats->fail < 0xFF)
+        {
+            p_stats->fail++;
+        }
+    }
+    else
+    {
+        free_head[block_class] = free_next[block];
+        free_next[block]       = POOL_IN_USE;
+
+        p_stats->used++;
+        if(p_stats->used > p_stats->peak)
+        {
+            p_stats->peak = p_stats->used;
+        }
+        p_block = &pool_area[p_info->offset + ((uint16_t)(block - p_info->first_block) * p_info->size)];
+    }
+
+    POOL_UNLOCK(gie);
+
+    return p_block;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Free Block
+ * @param
+ *     p_block:pointer returned by pool_alloc()
+ * @return
+ *     none:
+ * @note
+ *     O(1), can be called from isr() and main.
+ *     NULL, unknown pointer and double free are ignored
+ *===================================================*/
+void pool_free(void *p_block)
+{
+    const pool_class_info_t *p_info;
+    uint16_t offset;
+    uint8_t  block_class;
+    uint8_t  block;
+    uint8_t  gie;
+
+    if(((uint8_t *)p_block < &pool_area[0]) || ((uint8_t *)p_block >= &pool_area[POOL_AREA_SIZE]))
+    {
+        return;
+    }
+    offset = (uint16_t)((uint8_t *)p_block - &pool_area[0]);
+
+    /* Class is found by address (POOL_CLASS_NUM compares) */
+    for(block_class = 0; offset >= class_info[block_class].end; block_class++)
+    {
+        ;
+    }
+    p_info = &class_info[block_class];
+
+    offset -= p_info->offset;
+    if((offset % p_info->size) != 0)
+    {
+        return;
+    }
+    block = (uint8_t)(p_info->first_block + (offset / p_info->size));
+
+    POOL_LOCK(gie);
+
+    if(free_next[block] == POOL_IN_USE)
+    {
+        free_next[block]       = free_head[block_class];
+        free_head[block_class] = block;
+        stats[block_class].used--;
+    }
+
+    POOL_UNLOCK(gie);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Statistics of Class
+ * @param
+ *     block_class:class
+ * @return
+ *     pointer to statistics
+ * @note
+ *     none
+ *===================================================*/
+const pool_stats_t *pool_get_stats(pool_class_t block_class)
+{
+    return (const pool_stats_t *)&stats[block_class];
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Block Size of Class
+ * @param
+ *     block_class:class
+ * @return
+ *     bytes of a block
+ * @note
+ *     none
+ *===================================================*/
+uint8_t pool_get_size(pool_class_t block_class)
+{
+    return class_info[block_class].size;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Number of Blocks of Class
+ * @param
+ *     block_class:class
+ * @return
+ *     number of blocks
+ * @note
+ *     none
+ *===================================================*/
+uint8_t pool_get_num(pool_class_t block_class)
+{
+    return class_info[block_class].num;
+}
@@ -0,0 +1,151 @@
+#ifndef _POOL_H
+#define _POOL_H
+
+#include <stdint.h>
+
+
+/* Interrupt Lock (pool is used from isr() and main) */
+/*---------------------------------------------------
+ Host build (tools/pool_model.c) has no interrupt.
+---------------------------------------------------*/
+#if defined(__XC8)
+#include <xc.h>
+#define POOL_LOCK(gie)      do { (gie) = INTCONbits.GIE; di(); } while(0)
+#define POOL_UNLOCK(gie)    do { if(gie) { ei(); } } while(0)
+#else
+#define POOL_LOCK(gie)      do { (gie) = 0; } while(0)
+#define POOL_UNLOCK(gie)    do { (void)(gie); } while(0)
+#endif
+
+
+/* Block Class */
+/*---------------------------------------------------
+| Class       | Size | Num | Bytes | Use            |
+-----------------------------------------------------
+| POOL_SMALL  |    8 |   8 |    64 | Events, short  |
+|             |      |     |       | replies        |
+-----------------------------------------------------
+| POOL_FRAME  |   24 |   4 |    96 | Protocol frame |
+-----------------------------------------------------
+| POOL_LINE   |  100 |   1 |   100 | 1 line of      |
+|             |      |     |       | graphic mode   |
+-----------------------------------------------------
+|             |      |  13 |   260 | POOL_AREA_SIZE |
+-----------------------------------------------------
+ All blocks are in 1 array, which is over the 80 byte
+ of a bank and is placed in linear memory (0x2000 -)
+ by XC8. A feature needing RAM takes its blocks from
+ here instead of adding its own array, so the budget
+ is this table and the "pool" peak of the perf JSON.
+---------------------------------------------------*/
+typedef enum
+{
+    POOL_SMALL,
+    POOL_FRAME,
+    POOL_LINE,
+    POOL_CLASS_NUM,
+} pool_class_t;
+
+#define POOL_SMALL_SIZE     (8)
+#define POOL_SMALL_NUM      (8)
+#define POOL_FRAME_SIZE     (24)
+#define POOL_FRAME_NUM      (4)
+#define POOL_LINE_SIZE      (100)
+#define POOL_LINE_NUM       (1)
+
+#define POOL_BLOCK_NUM      (POOL_SMALL_NUM + POOL_FRAME_NUM + POOL_LINE_NUM)
+#define POOL_AREA_SIZE      ((POOL_SMALL_SIZE * POOL_SMALL_NUM) + \
+                             (POOL_FRAME_SIZE * POOL_FRAME_NUM) + \
+                             (POOL_LINE_SIZE  * POOL_LINE_NUM))
+
+
+/* Statistics of Class */
+typedef struct
+{
+    uint8_t used;
+    uint8_t peak;               // High-water mark of used
+    uint8_t fail;               // No free block (stops at 0xFF)
+} pool_stats_t;
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Pool (all blocks free)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void pool_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Allocate Block
+ * @param
+ *     block_class:class of the block
+ * @return
+ *     pointer to the block, NULL:No free block
+ * @note
+ *     O(1), can be called from isr() and main
+ *===================================================*/
+void *pool_alloc(pool_class_t block_class);
+
+
+/*=====================================================
+ * @brief
+ *     Free Block
+ * @param
+ *     p_block:pointer returned by pool_alloc()
+ * @return
+ *     none:
+ * @note
+ *     O(1), can be called from isr() and main.
+ *     NULL, unknown pointer and double free are ignored
+ *===================================================*/
+void pool_free(void *p_block);
+
+
+/*=====================================================
+ * @brief
+ *     Get Statistics of Class
+ * @param
+ *     block_class:class
+ * @return
+ *     pointer to statistics
+ * @note
+ *     none
+ *===================================================*/
+const pool_stats_t *pool_get_stats(pool_class_t block_class);
+
+
+/*=====================================================
+ * @brief
+ *     Get Block Size of Class
+ * @param
+ *     block_class:class
+ * @return
+ *     bytes of a block
+ * @note
+ *     none
+ *===================================================*/
+uint8_t pool_get_size(pool_class_t block_class);
+
+
+/*=====================================================
+ * @brief
+ *     Get Number of Blocks of Class
+ * @param
+ *     block_class:class
+ * @return
+ *     number of blocks
+ * @note
+ *     none
+ *===================================================*/
+uint8_t pool_get_num(pool_class_t block_class);
+
+
+#endif  /* _POOL_H */
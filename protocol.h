@@ -0,0 +1,138 @@
+#ifndef _PROTOCOL_H
+#define _PROTOCOL_H
+
+/*
+ * Link Protocol between Door Unit and Handset.
+ * This header must not include <xc.h>, it is shared
+ * with the host tools in tools/.
+ */
+
+
+/* Data Code */
+/*---------------------------------------------------
+| Code | Direction       | Meaning                  |
+-----------------------------------------------------
+| 0x01 | Unit -> Handset | Call (Button pressed)    |
+-----------------------------------------------------
+| 0x01 | Handset -> Unit | Responce1                |
+-----------------------------------------------------
+| 0x02 | Handset -> Unit | Responce2                |
+-----------------------------------------------------
+| 0x03 | Unit -> Handset | Responce is displayed    |
+-----------------------------------------------------
+| 0x04 | Unit -> Handset | Repeat Presses of Call   |
+|      |                 | + button, press count    |
+-----------------------------------------------------
+| 0x06 | Handset -> Unit | ACK of Call (Multi-drop) |
+-----------------------------------------------------
+| 0x10 | Handset -> Unit | Read Call Journal        |
+-----------------------------------------------------
+| 0x10 | Unit -> Handset | Call Journal (journal.h) |
+-----------------------------------------------------
+| 0x11 | Handset -> Unit | Read Cycle Counters      |
+-----------------------------------------------------
+| 0x11 | Unit -> Handset | Cycle Counters (perf.h)  |
+-----------------------------------------------------
+| 0x12 | Handset -> Unit | Read Latency Histograms  |
+-----------------------------------------------------
+| 0x12 | Unit -> Handset | Histograms (latency.h)   |
+-----------------------------------------------------
+| 0x13 | Unit -> Handset | Heartbeat (link.h)       |
+-----------------------------------------------------
+| 0x13 | Handset -> Unit | Heartbeat reply at once  |
+-----------------------------------------------------
+| 0x20 | Handset -> Unit | Enter Boot Loader        |
+-----------------------------------------------------
+| 0x30 | Handset -> Unit | Select Language 0 - 15   |
+| 0x3F | Unit -> Handset | (language.h), echoed     |
+|      |                 | when selected            |
+-----------------------------------------------------
+| 0x40 | Handset -> Unit | Responce of id 0 - 63    |
+| 0x7F |                 | (responce.h)             |
+---------------------------------------------------*/
+#define PROTOCOL_CALL           (0x01)
+#define PROTOCOL_RESPONCE1      (0x01)
+#define PROTOCOL_RESPONCE2      (0x02)
+#define PROTOCOL_SHOWN          (0x03)
+#define PROTOCOL_CALL_UPDATE    (0x04)
+#define PROTOCOL_ACK            (0x06)
+#define PROTOCOL_JOURNAL_READ   (0x10)
+#define PROTOCOL_PERF_READ      (0x11)
+#define PROTOCOL_LATENCY_READ   (0x12)
+#define PROTOCOL_PING           (0x13)
+#define PROTOCOL_PONG           (0x13)
+#define PROTOCOL_BOOT           (0x20)  // + PROTOCOL_BOOT_KEY, ~PROTOCOL_BOOT_KEY
+#define PROTOCOL_LANGUAGE_BASE  (0x30)
+#define PROTOCOL_LANGUAGE_MAX   (16)    // 0x30 - 0x3F
+#define PROTOCOL_RESPONCE_BASE  (0x40)
+#define PROTOCOL_RESPONCE_MAX   (64)    // 0x40 - 0x7F
+
+
+/* Multi-drop Address */
+#define PROTOCOL_HANDSET_ADDRESS   (0x00)
+#define PROTOCOL_BROADCAST_ADDRESS (0xFF)
+#define PROTOCOL_DEFAULT_ADDRESS   (0x01)  // Used when EEPROM is erased
+
+
+/* Multi-drop Frame */
+/*---------------------------------------------------
+| Direction      | 9th bit = 1 | 9th bit = 0        |
+-----------------------------------------------------
+| Unit -> Handset| 0x00        | Unit address, Data |
+-----------------------------------------------------
+| Handset -> Unit| Unit address| Data               |
+---------------------------------------------------*/
+
+
+/* Multi-drop Timing */
+#define PROTOCOL_BUS_IDLE_MS     (3)    // Bus must be idle before transmit
+#define PROTOCOL_ACK_TIMEOUT_MS  (50)
+#define PROTOCOL_BACKOFF_SLOT_MS (10)   // x (retry + 1) x ((address & 7) + 1)
+#define PROTOCOL_NOTIFY_RETRY    (4)
+
+
+/* Boot Loader (Point to Point only, bootloader.h) */
+/*---------------------------------------------------
+| Handset -> Unit              | Unit -> Handset    |
+-----------------------------------------------------
+| PROTOCOL_BOOT, KEY, ~KEY     | READY, max baud    |
+-----------------------------------------------------
+| BAUD, baud code              | READY (new baud)   |
+-----------------------------------------------------
+| WRITE, row address (H, L),   | WRITTEN / SKIPPED  |
+| 32 words (L, H), CRC (H, L)  | / NAK_xxx          |
+-----------------------------------------------------
+| EXIT                         | READY, then reset  |
+-----------------------------------------------------
+ CRC is CRC-16-CCITT (0x1021, initial 0xFFFF) of
+ row address and words. Row 0 must be written last.
+ The application enters the Boot Loader only when
+ KEY and ~KEY follow PROTOCOL_BOOT within
+ PROTOCOL_BOOT_KEY_MS each (a stray 0x20 is ignored).
+ In the Boot Loader, PROTOCOL_BOOT alone is enough.
+ BAUD is for a direct cable only: the Bluetooth
+ module stays at 9600 (BT_UART of bt_module.h).
+---------------------------------------------------*/
+#define PROTOCOL_BOOT_KEY       (0xDA)  // ~KEY 0x25 : not a Data Code
+#define PROTOCOL_BOOT_KEY_MS    (20)
+
+#define BOOT_CMD_BAUD       ('B')
+#define BOOT_CMD_WRITE      ('W')
+#define BOOT_CMD_EXIT       ('X')
+
+#define BOOT_READY          ('R')
+#define BOOT_WRITTEN        ('K')
+#define BOOT_SKIPPED        ('S')
+#define BOOT_NAK_CRC        ('C')
+#define BOOT_NAK_ADDRESS    ('A')
+#define BOOT_NAK_VERIFY     ('V')
+
+#define BOOT_BAUD_9600      (0)
+#define BOOT_BAUD_57600     (1)
+#define BOOT_BAUD_115200    (2)
+
+#define BOOT_ROW_WORDS      (32)
+#define BOOT_ADDRESS        (0x3C00)    // Boot Loader area (word address), never written
+
+
+#endif  /* _PROTOCOL_H */
@@ -0,0 +1,66 @@
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include "responce.h"
+#include "protocol.h"
+#include "timer_wheel.h"
+#include "chime.h"
+
+
+/* Descriptor Table (index : Responce id) */
+#define RESPONCE_DESC(name, hold_ms, chime)     {TIMER_TICKS(hold_ms), chime},
+
+static const responce_desc_t responce_table[RESPONCE_NUM] =
+{
+    RESPONCE_LIST(RESPONCE_DESC)
+};
+
+#undef RESPONCE_DESC
+
+
+/* Codes from PROTOCOL_RESPONCE_BASE must not reach other Data Codes */
+typedef char responce_num_check[(RESPONCE_NUM <= PROTOCOL_RESPONCE_MAX) ? 1 : -1];
+
+
+/*=====================================================
+ * @brief
+ *     Find Responce of Received Code
+ * @param
+ *     code:data received from the Handset
+ * @return
+ *     Responce id, RESPONCE_NONE:not a Responce
+ * @note
+ *     No search, the code is the index of the table
+ *===================================================*/
+uint8_t responce_find(uint8_t code)
+{
+    /* Codes of older Handsets */
+    if((code == PROTOCOL_RESPONCE1) || (code == PROTOCOL_RESPONCE2))
+    {
+        return (uint8_t)(code - PROTOCOL_RESPONCE1);
+    }
+
+    code = (uint8_t)(code - PROTOCOL_RESPONCE_BASE);
+    if(code >= RESPONCE_NUM)
+    {
+        return RESPONCE_NONE;
+    }
+
+    return code;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Responce Descriptor
+ * @param
+ *     id:Responce id (less than RESPONCE_NUM)
+ * @return
+ *     pointer to descriptor in flash
+ * @note
+ *     none
+ *===================================================*/
+const responce_desc_t *responce_get(uint8_t id)
+{
+    return &responce_table[id];
+}
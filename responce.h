@@ -0,0 +1,74 @@
+#ifndef _RESPONCE_H
+#define _RESPONCE_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+
+
+/* Responce List : X(name, hold_ms, chime) */
+/*---------------------------------------------------
+ The Handset sends Responce of id n (order of this
+ list) as PROTOCOL_RESPONCE_BASE + n. The first 2 are
+ also accepted as PROTOCOL_RESPONCE1 / 2 (older
+ Handsets). A new Responce adds 1 line here and its
+ message in each language pack (language.h), nothing
+ else.
+---------------------------------------------------*/
+#define RESPONCE_LIST(X)                        \
+    X(RESPONCE1,       20000, CHIME_RESPONCE)   \
+    X(RESPONCE2,       20000, CHIME_RESPONCE)   \
+    X(RESPONCE_WAIT,   60000, CHIME_RESPONCE)   \
+    X(RESPONCE_LEAVE,  30000, CHIME_RESPONCE)   \
+    X(RESPONCE_ABSENT, 20000, CHIME_NOT_HERE)
+
+
+/* Responce id */
+#define RESPONCE_ENUM(name, hold_ms, chime)     name,
+typedef enum
+{
+    RESPONCE_LIST(RESPONCE_ENUM)
+    RESPONCE_NUM,
+} responce_t;
+#undef RESPONCE_ENUM
+
+#define RESPONCE_NONE   (0xFF)  // Not a Responce code
+
+
+/* Responce Descriptor (in flash, message : language.h) */
+typedef struct
+{
+    uint16_t hold_ticks;        // TIMER_HOLD after the message is shown
+    uint8_t  chime;             // chime_melody_t
+} responce_desc_t;
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Find Responce of Received Code
+ * @param
+ *     code:data received from the Handset
+ * @return
+ *     Responce id, RESPONCE_NONE:not a Responce
+ * @note
+ *     No search, the code is the index of the table
+ *===================================================*/
+uint8_t responce_find(uint8_t code);
+
+
+/*=====================================================
+ * @brief
+ *     Get Responce Descriptor
+ * @param
+ *     id:Responce id (less than RESPONCE_NUM)
+ * @return
+ *     pointer to descriptor in flash
+ * @note
+ *     none
+ *===================================================*/
+const responce_desc_t *responce_get(uint8_t id);
+
+
+#endif  /* _RESPONCE_H */
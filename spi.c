@@ -0,0 +1,78 @@
+#include <xc.h>
+#include "spi.h"
+
+
+static spi_clock_t spi_clock;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize MSSP (SPI Master)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Can be called by each device, clock is set to
+ *     SPI_CLOCK_SLOW
+ *===================================================*/
+void spi_init(void)
+{
+    /* Pin I/O configuration */
+    SPI_SCK_IO = 0;
+    SPI_SDO_IO = 0;
+    SPI_SDI_IO = 1;
+
+    /* CKE = 0 : transmit on falling edge, devices latch on rising edge */
+    SSPSTAT   = 0x00;
+    SSPCON1   = (SSPCON1_SSPEN | SSPCON1_CKP | SPI_CLOCK_SLOW);
+    spi_clock = SPI_CLOCK_SLOW;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Change SPI Clock
+ * @param
+ *     clock:new clock
+ * @return
+ *     none:
+ * @note
+ *     MSSP is disabled while SSPM is changed.
+ *     Call only while every Chip Select is high
+ *===================================================*/
+void spi_set_clock(spi_clock_t clock)
+{
+    if(clock == spi_clock)
+    {
+        return;
+    }
+
+    SSPCON1   = 0x00;
+    SSPCON1   = (SSPCON1_SSPEN | SSPCON1_CKP | clock);
+    spi_clock = clock;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Transmit / Receive 1 Byte via MSSP
+ * @param
+ *     tx_data:1byte data to transmit
+ * @return
+ *     received data
+ * @note
+ *     none
+ *===================================================*/
+uint8_t spi_transfer(uint8_t tx_data)
+{
+    SSPBUF = tx_data;
+
+    /* Wait until transfer complete */
+    while(SSPSTATbits.BF == 0)
+    {
+        ;
+    }
+
+    return SSPBUF;
+}
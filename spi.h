@@ -0,0 +1,85 @@
+#ifndef _SPI_H
+#define _SPI_H
+
+#include <xc.h>
+#include <stdint.h>
+
+
+/* MSSP SPI Master, shared by the display (OLED_BUS_SPI) and the font flash */
+/*---------------------------------------------------
+| Device      | Chip Select | Clock               |
+-----------------------------------------------------
+| Display     | RA0         | SPI_CLOCK_SLOW      |
+-----------------------------------------------------
+| Font Flash  | RA4         | SPI_CLOCK_FAST      |
+-----------------------------------------------------
+ Both latch on the rising edge of SCK (Idle High,
+ mode 3). Every device restores SPI_CLOCK_SLOW when
+ its Chip Select goes high.
+---------------------------------------------------*/
+
+
+/* Pin Configuration (fixed by MSSP) */
+#define SPI_SCK_IO  TRISCbits.TRISC3
+#define SPI_SDI_IO  TRISCbits.TRISC4
+#define SPI_SDO_IO  TRISCbits.TRISC5
+
+
+/* SSPCON1 Register Mask */
+#define SSPCON1_SSPM_FOSC_4  (0b0000)  // SPI Master, Clock = Fosc/4
+#define SSPCON1_SSPM_FOSC_64 (0b0010)  // SPI Master, Clock = Fosc/64
+#define SSPCON1_CKP          (1 << 4)
+#define SSPCON1_SSPEN        (1 << 5)
+
+
+/* Clock */
+typedef enum
+{
+    SPI_CLOCK_SLOW = SSPCON1_SSPM_FOSC_64,
+    SPI_CLOCK_FAST = SSPCON1_SSPM_FOSC_4,
+} spi_clock_t;
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize MSSP (SPI Master)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Can be called by each device, clock is set to
+ *     SPI_CLOCK_SLOW
+ *===================================================*/
+void spi_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Change SPI Clock
+ * @param
+ *     clock:new clock
+ * @return
+ *     none:
+ * @note
+ *     MSSP is disabled while SSPM is changed.
+ *     Call only while every Chip Select is high
+ *===================================================*/
+void spi_set_clock(spi_clock_t clock);
+
+
+/*=====================================================
+ * @brief
+ *     Transmit / Receive 1 Byte via MSSP
+ * @param
+ *     tx_data:1byte data to transmit
+ * @return
+ *     received data
+ * @note
+ *     none
+ *===================================================*/
+uint8_t spi_transfer(uint8_t tx_data);
+
+
+#endif  /* _SPI_H */
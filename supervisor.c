@@ -0,0 +1,234 @@
+#include <xc.h>
+#include "supervisor.h"
+#include "systick.h"
+#include "perf.h"
+
+
+/* Prototype of Static Function */
+static uint8_t checksum(void);
+
+
+/* Warm State Check */
+#define WARM_MAGIC  (0x5A)
+
+
+/* Kept over a reset (not cleared by the startup code) */
+static __persistent warm_state_t warm;
+static __persistent uint8_t  warm_magic;
+static __persistent uint8_t  warm_check;
+static __persistent uint32_t last_tick;
+static __persistent uint8_t  restarts;
+
+
+/*=====================================================
+ * @brief
+ *     Find Reset Cause and Warm State
+ * @param
+ *     p_state:pointer to store warm state
+ * @return
+ *     cause of this restart (RESET_COLD : p_state is
+ *     not stored)
+ * @note
+ *     Call first in main(), before the flags of reset
+ *     are changed
+ *===================================================*/
+reset_cause_t supervisor_init(warm_state_t *p_state)
+{
+    reset_cause_t cause;
+
+    if((PCONbits.nPOR == 0) || (PCONbits.nBOR == 0))
+    {
+        cause = RESET_COLD;
+    }
+    else if(PCONbits.STKOVF || PCONbits.STKUNF)
+    {
+        cause = RESET_STACK;
+    }
+    else if(STATUSbits.nTO == 0)
+    {
+        cause = RESET_WATCHDOG;
+    }
+    else if(PCONbits.nRI == 0)
+    {
+        cause = RESET_SOFTWARE;
+    }
+    else
+    {
+        cause = RESET_COLD;
+    }
+
+    /* Arm the flags for the next reset (nTO is set by CLRWDT) */
+    PCONbits.nPOR   = 1;
+    PCONbits.nBOR   = 1;
+    PCONbits.nRI    = 1;
+    PCONbits.STKOVF = 0;
+    PCONbits.STKUNF = 0;
+    CLRWDT();
+
+    if((cause != RESET_COLD) && ((warm_magic != WARM_MAGIC) || (warm_check != checksum())))
+    {
+        cause = RESET_COLD;
+    }
+
+    if(cause == RESET_COLD)
+    {
+        restarts = 0;
+        supervisor_invalidate();
+    }
+    else
+    {
+        if(restarts < 0xFF)
+        {
+            restarts++;
+        }
+        *p_state = warm;
+    }
+
+    return cause;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Start Watchdog
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void supervisor_start(void)
+{
+    CLRWDT();
+    WDTCON = (WDTCON_WDTPS_512MS | WDTCON_SWDTEN);
+    PERF_BEGIN(PERF_WDT_KICK);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Kick Watchdog (main loop, each record of a dump)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     System tick is also saved for warm restart.
+ *     Time between kicks is probe PERF_WDT_KICK
+ *===================================================*/
+void supervisor_kick(void)
+{
+    PERF_END(PERF_WDT_KICK);
+    CLRWDT();
+    last_tick = systick_get();
+    PERF_BEGIN(PERF_WDT_KICK);
+}
+
+
+/*=====================================================
+ * @brief
+ *     Save Warm State
+ * @param
+ *     p_state:state to restore after a warm restart
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void supervisor_save(const warm_state_t *p_state)
+{
+    warm       = *p_state;
+    warm_check = checksum();
+    warm_magic = WARM_MAGIC;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Invalidate Warm State
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Next restart is cold (before boot_main())
+ *===================================================*/
+void supervisor_invalidate(void)
+{
+    warm_magic = 0;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Warm Restart Now
+ * @param
+ *     none:
+ * @return
+ *     none: (never returns)
+ * @note
+ *     Used when the display stops responding
+ *===================================================*/
+void supervisor_restart(void)
+{
+    last_tick = systick_get();
+    RESET();
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get System Tick at the Last Kick
+ * @param
+ *     none:
+ * @return
+ *     tick to resume after a warm restart
+ * @note
+ *     none
+ *===================================================*/
+uint32_t supervisor_get_tick(void)
+{
+    return last_tick;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Warm Restart Count
+ * @param
+ *     none:
+ * @return
+ *     warm restarts since power on (stops at 255)
+ * @note
+ *     none
+ *===================================================*/
+uint8_t supervisor_get_restarts(void)
+{
+    return restarts;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Checksum of Warm State
+ * @param
+ *     none:
+ * @return
+ *     sum of the bytes (0xA5 : all zero)
+ * @note
+ *     none
+ *---------------------------------------------------*/
+static uint8_t checksum(void)
+{
+    const uint8_t *p_byte = (const uint8_t *)&warm;
+    uint8_t sum = 0xA5;
+    uint8_t i;
+
+    for(i = 0; i < sizeof(warm); i++)
+    {
+        sum += p_byte[i];
+    }
+
+    return sum;
+}
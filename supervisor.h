@@ -0,0 +1,170 @@
+#ifndef _SUPERVISOR_H
+#define _SUPERVISOR_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+
+
+/* Watchdog (WDTE = SWDTEN, enabled after the cold boot delays) */
+/*---------------------------------------------------
+ Kicked by the main loop, by each record of a dump
+ (journal, perf, latency) and by each retry and
+ backoff slot of usart_notify(). Period is 320ms -
+ 864ms (LFINTOSC) : any other loop over 320ms resets
+ the Unit. put_char() does not kick, so a runaway
+ loop that transmits is also reset.
+---------------------------------------------------*/
+#define SUPERVISOR_WDT_MS   (512)
+#define WDTCON_WDTPS_512MS  (0b01001 << 1)  // LFINTOSC / 16384
+#define WDTCON_SWDTEN       (1 << 0)
+
+
+/* Reset Cause */
+/*---------------------------------------------------
+| Cause            | Flag            | Restart      |
+-----------------------------------------------------
+| Power on, BOR    | nPOR, nBOR      | Cold         |
+-----------------------------------------------------
+| Watchdog         | nTO             | Warm         |
+-----------------------------------------------------
+| Stack over/under | STKOVF, STKUNF  | Warm         |
+|                  | (STVREN = ON)   |              |
+-----------------------------------------------------
+| RESET            | nRI             | Warm         |
+| (display fault)  |                 |              |
+-----------------------------------------------------
+ Warm restart needs a valid warm state (persistent
+ RAM is not cleared by the startup code), otherwise
+ it is a cold restart.
+---------------------------------------------------*/
+typedef enum
+{
+    RESET_COLD,
+    RESET_WATCHDOG,
+    RESET_STACK,
+    RESET_SOFTWARE,
+} reset_cause_t;
+
+
+/* Warm State (saved by main at each change of Call State) */
+typedef struct
+{
+    uint8_t  call_state;
+    uint8_t  call_button;
+    uint8_t  screen;
+    uint32_t notify_tick;
+    uint32_t deadline;          // Tick when the state times out
+} warm_state_t;
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Find Reset Cause and Warm State
+ * @param
+ *     p_state:pointer to store warm state
+ * @return
+ *     cause of this restart (RESET_COLD : p_state is
+ *     not stored)
+ * @note
+ *     Call first in main(), before the flags of reset
+ *     are changed
+ *===================================================*/
+reset_cause_t supervisor_init(warm_state_t *p_state);
+
+
+/*=====================================================
+ * @brief
+ *     Start Watchdog
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void supervisor_start(void);
+
+
+/*=====================================================
+ * @brief
+ *     Kick Watchdog (main loop, each record of a dump)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     System tick is also saved for warm restart.
+ *     Time between kicks is probe PERF_WDT_KICK
+ *===================================================*/
+void supervisor_kick(void);
+
+
+/*=====================================================
+ * @brief
+ *     Save Warm State
+ * @param
+ *     p_state:state to restore after a warm restart
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void supervisor_save(const warm_state_t *p_state);
+
+
+/*=====================================================
+ * @brief
+ *     Invalidate Warm State
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Next restart is cold (before boot_main())
+ *===================================================*/
+void supervisor_invalidate(void);
+
+
+/*=====================================================
+ * @brief
+ *     Warm Restart Now
+ * @param
+ *     none:
+ * @return
+ *     none: (never returns)
+ * @note
+ *     Used when the display stops responding
+ *===================================================*/
+void supervisor_restart(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get System Tick at the Last Kick
+ * @param
+ *     none:
+ * @return
+ *     tick to resume after a warm restart
+ * @note
+ *     none
+ *===================================================*/
+uint32_t supervisor_get_tick(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get Warm Restart Count
+ * @param
+ *     none:
+ * @return
+ *     warm restarts since power on (stops at 255)
+ * @note
+ *     none
+ *===================================================*/
+uint8_t supervisor_get_restarts(void);
+
+
+#endif  /* _SUPERVISOR_H */
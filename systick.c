@@ -0,0 +1,130 @@
+#include <xc.h>
+#include "systick.h"
+#include "timer_wheel.h"
+#include "chime.h"
+
+
+/* Tick Counter */
+static volatile uint32_t systick_count;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize System Tick (Timer2)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Interrupt is enabled by button_interrupt_init()
+ *     (GIE, PEIE)
+ *===================================================*/
+void systick_init(void)
+{
+    systick_count = 0;
+
+    TMR2 = 0;
+    systick_set_period(clock_get_mode());
+
+    /* Enable Timer2 Interrupt */
+    PIR1bits.TMR2IF = 0;
+    PIE1bits.TMR2IE = 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Set Timer2 Period for Clock Mode
+ * @param
+ *     mode:current clock mode
+ * @return
+ *     none:
+ * @note
+ *     Called by clock_set_mode()
+ *===================================================*/
+void systick_set_period(clock_mode_t mode)
+{
+    switch(mode)
+    {
+        case CLOCK_MODE_IDLE:
+            PR2   = SYSTICK_PR2_IDLE;
+            T2CON = (T2CON_T2OUTPS_10 | T2CON_TMR2ON | T2CON_T2CKPS_1);
+            break;
+
+        case CLOCK_MODE_FAST:
+            PR2   = SYSTICK_PR2_FAST;
+            T2CON = (T2CON_T2OUTPS_10 | T2CON_TMR2ON | T2CON_T2CKPS_16);
+            break;
+
+        default:
+            PR2   = SYSTICK_PR2_FULL;
+            T2CON = (T2CON_T2OUTPS_10 | T2CON_TMR2ON | T2CON_T2CKPS_16);
+            break;
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     System Tick Interrupt
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called by irq_dispatch() when TMR2IF is set.
+ *     Timer Wheel and Chime are advanced here
+ *===================================================*/
+void systick_isr(void)
+{
+    systick_count++;
+    timer_tick();
+    chime_tick();
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get System Tick
+ * @param
+ *     none:
+ * @return
+ *     ticks since power on [SYSTICK_PERIOD_MS]
+ * @note
+ *     none
+ *===================================================*/
+uint32_t systick_get(void)
+{
+    uint32_t tick;
+    uint8_t tmr2ie;
+
+    /* 32bit read is not atomic (also called from isr()) */
+    tmr2ie = PIE1bits.TMR2IE;
+    PIE1bits.TMR2IE = 0;
+    tick = systick_count;
+    PIE1bits.TMR2IE = tmr2ie;
+
+    return tick;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Resume System Tick
+ * @param
+ *     tick:tick saved before a warm restart
+ * @return
+ *     none:
+ * @note
+ *     Timeouts saved as ticks stay valid over the
+ *     restart
+ *===================================================*/
+void systick_resume(uint32_t tick)
+{
+    uint8_t tmr2ie;
+
+    tmr2ie = PIE1bits.TMR2IE;
+    PIE1bits.TMR2IE = 0;
+    systick_count = tick;
+    PIE1bits.TMR2IE = tmr2ie;
+}
@@ -0,0 +1,107 @@
+#ifndef _SYSTICK_H
+#define _SYSTICK_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+#include "pic_clock.h"
+
+
+/* Tick Period */
+#define SYSTICK_PERIOD_MS (10)                          // 10ms
+#define SYSTICK_MS(ms)    ((ms) / SYSTICK_PERIOD_MS)    // [ms] -> [tick]
+
+
+/* T2CON Register Mask */
+#define T2CON_T2CKPS_1    (0b00 << 0)
+#define T2CON_T2CKPS_16   (0b10 << 0)
+#define T2CON_TMR2ON      (1 << 2)
+#define T2CON_T2OUTPS_10  (0b1001 << 3)
+
+
+/* Timer2 Setting of each Clock Mode (Postscaler 1:10 -> 100Hz) */
+/*---------------------------------------------------
+| Mode | Fosc/4 | Prescaler | PR2 | Tick            |
+-----------------------------------------------------
+| IDLE | 125kHz |   1:1     | 124 | 10.00ms         |
+-----------------------------------------------------
+| FULL | 2.5MHz |   1:16    | 155 |  9.98ms         |
+-----------------------------------------------------
+| FAST | 4MHz   |   1:16    | 249 | 10.00ms         |
+---------------------------------------------------*/
+#define SYSTICK_PR2_IDLE  (124)
+#define SYSTICK_PR2_FULL  (155)
+#define SYSTICK_PR2_FAST  (249)
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize System Tick (Timer2)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Interrupt is enabled by button_interrupt_init()
+ *     (GIE, PEIE)
+ *===================================================*/
+void systick_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Set Timer2 Period for Clock Mode
+ * @param
+ *     mode:current clock mode
+ * @return
+ *     none:
+ * @note
+ *     Called by clock_set_mode()
+ *===================================================*/
+void systick_set_period(clock_mode_t mode);
+
+
+/*=====================================================
+ * @brief
+ *     System Tick Interrupt
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called by irq_dispatch() when TMR2IF is set.
+ *     Timer Wheel and Chime are advanced here
+ *===================================================*/
+void systick_isr(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get System Tick
+ * @param
+ *     none:
+ * @return
+ *     ticks since power on [SYSTICK_PERIOD_MS]
+ * @note
+ *     none
+ *===================================================*/
+uint32_t systick_get(void);
+
+
+/*=====================================================
+ * @brief
+ *     Resume System Tick
+ * @param
+ *     tick:tick saved before a warm restart
+ * @return
+ *     none:
+ * @note
+ *     Timeouts saved as ticks stay valid over the
+ *     restart
+ *===================================================*/
+void systick_resume(uint32_t tick);
+
+
+#endif  /* _SYSTICK_H */
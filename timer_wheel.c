@@ -0,0 +1,168 @@
+#include <xc.h>
+#include "timer_wheel.h"
+
+
+/* Wheel */
+static volatile uint16_t slot_mask[TIMER_SLOT_NUM];    // Timers in each slot
+static volatile uint8_t  wheel_pos;                     // Slot of current tick
+
+/* Timer */
+static volatile uint8_t  timer_slot[TIMER_NUM];
+static volatile uint16_t timer_round[TIMER_NUM];       // Rounds left
+static volatile uint16_t expired_mask;
+
+
+/*=====================================================
+ * @brief
+ *     Initialize Timer Wheel
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Must be called before systick_init()
+ *===================================================*/
+void timer_init(void)
+{
+    uint8_t i;
+
+    for(i = 0; i < TIMER_SLOT_NUM; i++)
+    {
+        slot_mask[i] = 0;
+    }
+    wheel_pos    = 0;
+    expired_mask = 0;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Start (or Restart) Timer
+ * @param
+ *     id   :timer to start
+ *     ticks:time to expire [SYSTICK_PERIOD_MS]
+ * @return
+ *     none:
+ * @note
+ *     Can be called from isr() and main
+ *===================================================*/
+void timer_start(timer_id_t id, uint16_t ticks)
+{
+    uint16_t bit = (uint16_t)(1U << id);
+    uint8_t  slot;
+    uint8_t  tmr2ie;
+
+    if(ticks == 0)
+    {
+        ticks = 1;
+    }
+
+    /* Wheel is moved by timer_tick() */
+    tmr2ie = PIE1bits.TMR2IE;
+    PIE1bits.TMR2IE = 0;
+
+    slot_mask[timer_slot[id]] &= ~bit;
+    expired_mask &= ~bit;
+
+    slot = (uint8_t)((wheel_pos + ticks) & (TIMER_SLOT_NUM - 1));
+    timer_slot[id]  = slot;
+    timer_round[id] = (ticks - 1) / TIMER_SLOT_NUM;
+    slot_mask[slot] |= bit;
+
+    PIE1bits.TMR2IE = tmr2ie;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Stop Timer
+ * @param
+ *     id:timer to stop
+ * @return
+ *     none:
+ * @note
+ *     Expiration not yet taken is also cleared.
+ *     Can be called from isr() and main
+ *===================================================*/
+void timer_stop(timer_id_t id)
+{
+    uint16_t bit = (uint16_t)(1U << id);
+    uint8_t  tmr2ie;
+
+    tmr2ie = PIE1bits.TMR2IE;
+    PIE1bits.TMR2IE = 0;
+
+    slot_mask[timer_slot[id]] &= ~bit;
+    expired_mask &= ~bit;
+
+    PIE1bits.TMR2IE = tmr2ie;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Take Expiration of Timer
+ * @param
+ *     id:timer to check
+ * @return
+ *     1:Expired (only once), 0:Running or Stopped
+ * @note
+ *     none
+ *===================================================*/
+uint8_t timer_expired(timer_id_t id)
+{
+    uint16_t bit = (uint16_t)(1U << id);
+    uint8_t  tmr2ie;
+
+    if((expired_mask & bit) == 0)
+    {
+        return 0;
+    }
+
+    tmr2ie = PIE1bits.TMR2IE;
+    PIE1bits.TMR2IE = 0;
+    expired_mask &= ~bit;
+    PIE1bits.TMR2IE = tmr2ie;
+
+    return 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Advance Timer Wheel
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from systick_isr()
+ *===================================================*/
+void timer_tick(void)
+{
+    uint16_t mask;
+    uint8_t  id;
+    uint16_t bit;
+
+    wheel_pos = (wheel_pos + 1) & (TIMER_SLOT_NUM - 1);
+
+    mask = slot_mask[wheel_pos];
+    for(id = 0, bit = 1; mask != 0; id++, bit <<= 1)
+    {
+        if((mask & bit) == 0)
+        {
+            continue;
+        }
+        mask &= ~bit;
+
+        if(timer_round[id] == 0)
+        {
+            slot_mask[wheel_pos] &= ~bit;
+            expired_mask |= bit;
+        }
+        else
+        {
+            timer_round[id]--;
+        }
+    }
+}
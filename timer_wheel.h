@@ -0,0 +1,108 @@
+#ifndef _TIMER_WHEEL_H
+#define _TIMER_WHEEL_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+#include "systick.h"
+
+
+/* Timer ID (1 bit each in the wheel slot, up to 16) */
+typedef enum
+{
+    TIMER_DEBOUNCE,     // Chattering of Button
+    TIMER_RESPONCE,     // Waiting for Responce from Handset
+    TIMER_HOLD,         // Message is held on the display
+    TIMER_BT,           // AT command mode and reply of Bluetooth module
+    TIMER_BT_RELINK,    // Link down -> module reset
+    TIMER_LINK,         // Heartbeat interval and reply timeout
+    TIMER_CALL_UPDATE,  // Press count update to Handset
+    TIMER_DISPLAY,      // Marquee scroll step
+    TIMER_ANIM,         // Animation frame tick
+    TIMER_TRANSITION,   // Screen wipe step
+    TIMER_NUM,
+} timer_id_t;
+
+
+/* Wheel Size */
+/*---------------------------------------------------
+ Timer expiring in T ticks is put in slot
+ (current + T) % TIMER_SLOT_NUM and skips
+ (T - 1) / TIMER_SLOT_NUM rounds of the wheel.
+ Each tick visits only 1 slot, so the cost of a tick
+ does not depend on how far the timers are.
+---------------------------------------------------*/
+#define TIMER_SLOT_NUM      (16)    // Power of 2
+#define TIMER_TICKS(ms)     ((uint16_t)SYSTICK_MS(ms))
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Initialize Timer Wheel
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Must be called before systick_init()
+ *===================================================*/
+void timer_init(void);
+
+
+/*=====================================================
+ * @brief
+ *     Start (or Restart) Timer
+ * @param
+ *     id   :timer to start
+ *     ticks:time to expire [SYSTICK_PERIOD_MS]
+ * @return
+ *     none:
+ * @note
+ *     Can be called from isr() and main
+ *===================================================*/
+void timer_start(timer_id_t id, uint16_t ticks);
+
+
+/*=====================================================
+ * @brief
+ *     Stop Timer
+ * @param
+ *     id:timer to stop
+ * @return
+ *     none:
+ * @note
+ *     Expiration not yet taken is also cleared.
+ *     Can be called from isr() and main
+ *===================================================*/
+void timer_stop(timer_id_t id);
+
+
+/*=====================================================
+ * @brief
+ *     Take Expiration of Timer
+ * @param
+ *     id:timer to check
+ * @return
+ *     1:Expired (only once), 0:Running or Stopped
+ * @note
+ *     none
+ *===================================================*/
+uint8_t timer_expired(timer_id_t id);
+
+
+/*=====================================================
+ * @brief
+ *     Advance Timer Wheel
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called from systick_isr()
+ *===================================================*/
+void timer_tick(void);
+
+
+#endif  /* _TIMER_WHEEL_H */
@@ -0,0 +1,215 @@
+/*
+ * anim_cost : Frame cost of the wait indicator of animation.c
+ *
+ * Runs the animation engine of animation.c tick by tick for one wait of
+ * the door unit (spinner + countdown bar, as started by call_notify() of
+ * main.c) and reports what each tick writes to the display:
+ *
+ *   - changed columns of each spinner frame (sprite data of anim_sprite.c)
+ *   - columns, address commands and bus bytes per tick, under
+ *     ANIM_COLUMN_BUDGET
+ *   - time of the worst tick and the bytes received by the USART meanwhile,
+ *     against USART_RX_BUF_SIZE (main loop does not read during a tick)
+ *
+ * Build:
+ *     cc -O2 -Wall -I. -o anim_cost tools/anim_cost.c anim_sprite.c
+ *
+ * Usage:
+ *     anim_cost [-u bus_byte_us] [-b baud] [-r rx_buf_size] [-t wait_ms]
+ *               [-w bar_width] [-v]
+ *
+ *     bus_byte_us : time of 1 display byte at CLOCK_MODE_FAST
+ *                   (default 40, OLED_BUS_SPI 10bit frame at Fosc/64)
+ *     -v          : print every tick
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "anim_sprite.h"
+
+
+/* main.c / usart.h */
+#define WAIT_SPINNER_X      (28)
+#define WAIT_SPINNER_LINE   (0)
+#define WAIT_PROGRESS_LINE  (1)
+#define SYSTICK_PERIOD_MS   (10)
+
+
+/* Tick Cost */
+typedef struct
+{
+    int columns;
+    int commands;
+} cost_t;
+
+
+/* Display model : address counter of LCD */
+static int bus_x;
+static int bus_line;
+
+static void put_column(cost_t *p_cost, int x, int line)
+{
+    if(line != bus_line)
+    {
+        p_cost->commands++;
+        bus_line = line;
+        bus_x    = -1;
+    }
+    if(x != bus_x)
+    {
+        p_cost->commands++;
+    }
+    p_cost->columns++;
+    bus_x = x + 1;
+}
+
+
+/*-----------------------------------------------------
+ * Changed columns between frames of a sprite
+ *---------------------------------------------------*/
+static void frame_table(const anim_sprite_t *p_sprite)
+{
+    const uint8_t *p_from;
+    const uint8_t *p_to;
+    int f, c, changed;
+
+    printf("spinner : %d x 8, %d frames, %d ms/frame\n",
+           p_sprite->width, p_sprite->frame_num, p_sprite->frame_ticks * ANIM_TICK_MS);
+    printf("  frame  changed columns\n");
+    for(f = 0; f < p_sprite->frame_num; f++)
+    {
+        p_from = &p_sprite->p_frames[((f + p_sprite->frame_num - 1) % p_sprite->frame_num) * p_sprite->width];
+        p_to   = &p_sprite->p_frames[f * p_sprite->width];
+        for(c = 0, changed = 0; c < p_sprite->width; c++)
+        {
+            changed += (p_from[c] != p_to[c]);
+        }
+        printf("  %5d  %d\n", f, changed);
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    const anim_sprite_t *p_sprite = &anim_spinner;
+    double byte_us = 40.0;
+    int baud = 9600;
+    int rx_buf = 8;
+    int wait_ms = 20000;
+    int width = 100;
+    int verbose = 0;
+    int opt;
+
+    uint8_t shown[ANIM_SPRITE_WIDTH_MAX] = {0};
+    int frame = 0, frame_tick = 0;
+    int shown_fill = 0, target;
+    int wait_ticks, elapsed;
+    int tick, ticks, slot, first_slot = 0, i, c, budget;
+    const uint8_t *p_column;
+    cost_t cost;
+    long total_bytes = 0;
+    int max_bytes = 0, max_tick = 0, deferred_ticks = 0;
+    double max_us, rx_bytes;
+
+    while((opt = getopt(argc, argv, "u:b:r:t:w:v")) != -1)
+    {
+        switch(opt)
+        {
+            case 'u': byte_us = atof(optarg); break;
+            case 'b': baud    = atoi(optarg); break;
+            case 'r': rx_buf  = atoi(optarg); break;
+            case 't': wait_ms = atoi(optarg); break;
+            case 'w': width   = atoi(optarg); break;
+            case 'v': verbose = 1; break;
+            default:
+                fprintf(stderr, "usage: anim_cost [-u bus_byte_us] [-b baud] [-r rx_buf_size] "
+                                "[-t wait_ms] [-w bar_width] [-v]\n");
+                return 1;
+        }
+    }
+
+    frame_table(p_sprite);
+
+    /* Same steps as anim_task(), time in systick */
+    wait_ticks = wait_ms / SYSTICK_PERIOD_MS;
+    ticks      = wait_ms / ANIM_TICK_MS;
+    for(tick = 1; tick <= ticks; tick++)
+    {
+        cost.columns  = 0;
+        cost.commands = 0;
+        bus_x    = -1;
+        bus_line = -1;
+        budget   = ANIM_COLUMN_BUDGET;
+
+        for(i = 0, slot = first_slot; i < 2; i++, slot ^= 1)
+        {
+            if(slot == 0)
+            {
+                if(++frame_tick >= p_sprite->frame_ticks)
+                {
+                    frame_tick = 0;
+                    frame = (frame + 1) % p_sprite->frame_num;
+                }
+                p_column = &p_sprite->p_frames[frame * p_sprite->width];
+                for(c = 0; c < p_sprite->width && budget > 0; c++)
+                {
+                    if(p_column[c] != shown[c])
+                    {
+                        put_column(&cost, WAIT_SPINNER_X + c, WAIT_SPINNER_LINE);
+                        shown[c] = p_column[c];
+                        budget--;
+                    }
+                }
+            }
+            else
+            {
+                elapsed = tick * ANIM_TICK_MS / SYSTICK_PERIOD_MS;
+                if(elapsed > wait_ticks)
+                {
+                    elapsed = wait_ticks;
+                }
+                target = (int)((long)width * (wait_ticks - elapsed) / wait_ticks);
+                while(shown_fill != target && budget > 0)
+                {
+                    if(shown_fill < target)
+                    {
+                        put_column(&cost, shown_fill++, WAIT_PROGRESS_LINE);
+                    }
+                    else
+                    {
+                        put_column(&cost, --shown_fill, WAIT_PROGRESS_LINE);
+                    }
+                    budget--;
+                }
+                if(shown_fill != target)
+                {
+                    deferred_ticks++;
+                }
+            }
+        }
+        first_slot ^= 1;
+
+        total_bytes += cost.columns + cost.commands;
+        if(cost.columns + cost.commands > max_bytes)
+        {
+            max_bytes = cost.columns + cost.commands;
+            max_tick  = tick;
+        }
+        if(verbose)
+        {
+            printf("tick %4d : %2d columns, %2d commands\n", tick, cost.columns, cost.commands);
+        }
+    }
+
+    max_us   = max_bytes * byte_us;
+    rx_bytes = max_us / (10.0e6 / baud);
+    printf("wait %d ms, %d ticks of %d ms, budget %d columns/tick\n",
+           wait_ms, ticks, ANIM_TICK_MS, ANIM_COLUMN_BUDGET);
+    printf("bus bytes/tick : avg %.1f, max %d (tick %d), bar behind time in %d ticks\n",
+           (double)total_bytes / ticks, max_bytes, max_tick, deferred_ticks);
+    printf("worst tick %.0f us, %.1f bytes received at %d baud (rx buffer %d) : %s\n",
+           max_us, rx_bytes, baud, rx_buf, (rx_bytes < rx_buf) ? "ok" : "OVERRUN");
+
+    return (rx_bytes < rx_buf) ? 0 : 2;
+}
@@ -0,0 +1,567 @@
+/*
+ * boot_send : Firmware update of the door unit over the serial link
+ *
+ * Sends an Intel HEX image (XC8 output) to the boot loader of
+ * bootloader.c (point to point only, see protocol.h):
+ *
+ *   PROTOCOL_BOOT, KEY, ~KEY   -> READY, max baud
+ *   BAUD, code                 -> READY (both sides change baudrate, -b only)
+ *   WRITE, row, words, CRC     -> WRITTEN / SKIPPED / NAK_xxx
+ *   EXIT                       -> READY, unit resets
+ *
+ * The image must not have data at or above BOOT_ADDRESS: the boot loader
+ * area is never written, so such rows would be lost. Strip the boot
+ * loader from the XC8 output first (bootloader.h):
+ *
+ *     hexmate intercom.hex,0-77FF -Oupdate.hex
+ *
+ * The link stays at 9600 unless -b is given: the Bluetooth module is
+ * fixed at 9600 on its UART side (BT_UART of bt_module.h) and passes no
+ * other rate. Use -b 1 / 2 only on a direct cable to the unit.
+ *
+ * Configuration words and EEPROM data are not sent.
+ * Row 0 (reset vector) is sent last; the boot loader keeps a jump to
+ * itself there until then, so an interrupted update is restarted
+ * from power on.
+ *
+ * With -M the unit is replaced by a host model of the boot loader and
+ * its flash (initial contents from the given HEX, or erased with "-"),
+ * so that the protocol and the row skipping can be checked without a
+ * door unit. Like the boot loader, the model puts the jump to itself in
+ * row 0 before the first changed row, and reports the number of erased
+ * rows.
+ *
+ * Build:
+ *     cc -O2 -Wall -I. -o boot_send tools/boot_send.c
+ *
+ * Usage:
+ *     boot_send [-D device | -M old.hex|-] [-b 0|1|2] [-r retry] image.hex
+ *
+ *     -D  serial device, starts at 9600 8N1 (default /dev/ttyUSB0)
+ *     -M  flash model instead of a device
+ *     -b  baud code, BOOT_BAUD_xxx of protocol.h, direct cable only
+ *         (default 0 : 9600, no change)
+ *     -r  retries of a row on NAK or timeout    (default 3)
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "protocol.h"
+#include "bootloader.h"
+
+
+#define FLASH_WORDS     (BOOT_FLASH_WORDS)
+#define ERASED_WORD     (BOOT_ERASED_WORD)
+#define ROW_NUM         (FLASH_WORDS / BOOT_ROW_WORDS)
+#define REPLY_MS        (1000)
+
+
+/* Image */
+static uint16_t image[FLASH_WORDS];
+static uint8_t  image_row[ROW_NUM];     // 1 : row has data
+
+/* Port */
+static int fd;
+
+/* Results */
+static long cnt_written, cnt_skipped, cnt_retry;
+static long cnt_bytes;
+
+
+/*-----------------------------------------------------
+ * Utility
+ *---------------------------------------------------*/
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static uint16_t crc16(uint16_t crc, uint8_t data)
+{
+    int i;
+
+    crc ^= (uint16_t)data << 8;
+    for(i = 0; i < 8; i++)
+    {
+        crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void send_bytes(int port, const uint8_t *data, int len)
+{
+    if(write(port, data, len) != len)
+    {
+        perror("write");
+        exit(1);
+    }
+    cnt_bytes += len;
+}
+
+/* -1 : timeout */
+static int receive_byte(int port, int timeout_ms)
+{
+    struct pollfd pfd;
+    uint8_t data;
+
+    pfd.fd     = port;
+    pfd.events = POLLIN;
+    if(poll(&pfd, 1, timeout_ms) <= 0 || read(port, &data, 1) != 1)
+    {
+        return -1;
+    }
+    return data;
+}
+
+
+/*-----------------------------------------------------
+ * Intel HEX (byte address, 2 bytes per word)
+ *---------------------------------------------------*/
+static int load_hex(const char *name, uint16_t *flash, uint8_t *used)
+{
+    FILE *fp;
+    char line[600];
+    unsigned len, addr, type, data, sum;
+    uint32_t base = 0;
+    uint32_t byte_addr;
+    uint32_t word;
+    unsigned i;
+
+    for(i = 0; i < FLASH_WORDS; i++)
+    {
+        flash[i] = ERASED_WORD;
+    }
+    if((fp = fopen(name, "r")) == NULL)
+    {
+        perror(name);
+        exit(1);
+    }
+    while(fgets(line, sizeof(line), fp) != NULL)
+    {
+        if(line[0] != ':' || sscanf(line + 1, "%2x%4x%2x", &len, &addr, &type) != 3)
+        {
+            continue;
+        }
+        sum = len + (addr >> 8) + (addr & 0xFF) + type;
+        for(i = 0; i <= len; i++)
+        {
+            if(sscanf(line + 9 + (i * 2), "%2x", &data) != 1)
+            {
+                fprintf(stderr, "%s: short record\n", name);
+                exit(1);
+            }
+            sum += data;
+
+            if(type == 0 && i < len)
+            {
+                byte_addr = base + addr + i;
+                word = byte_addr >> 1;
+                if(word >= FLASH_WORDS)
+                {
+                    continue;   // Configuration words, EEPROM data
+                }
+                if(byte_addr & 1)
+                {
+                    flash[word] = (uint16_t)((flash[word] & 0x00FF) | ((data & 0x3F) << 8));
+                }
+                else
+                {
+                    flash[word] = (uint16_t)((flash[word] & 0xFF00) | data);
+                }
+                if(used != NULL)
+                {
+                    used[word / BOOT_ROW_WORDS] = 1;
+                }
+            }
+        }
+        if((sum & 0xFF) != 0)
+        {
+            fprintf(stderr, "%s: checksum error\n", name);
+            exit(1);
+        }
+        if(type == 4)
+        {
+            sscanf(line + 9, "%4x", &data);
+            base = (uint32_t)data << 16;
+        }
+        else if(type == 1)
+        {
+            break;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+
+/*-----------------------------------------------------
+ * Flash Model (same rules as boot_main() of bootloader.c)
+ *---------------------------------------------------*/
+static void model_main(int port, const char *old_hex)
+{
+    static uint16_t flash[FLASH_WORDS];
+    uint8_t row[2 + (BOOT_ROW_WORDS * 2) + 2];
+    uint16_t crc;
+    uint16_t address;
+    uint16_t word;
+    long erased = 0;
+    int stub_written;
+    int result;
+    int data;
+    int count;
+    int i;
+
+    if(strcmp(old_hex, "-") == 0)
+    {
+        for(i = 0; i < FLASH_WORDS; i++)
+        {
+            flash[i] = ERASED_WORD;
+        }
+    }
+    else
+    {
+        load_hex(old_hex, flash, NULL);
+    }
+
+    /* Row 0 is not the jump while the application is intact */
+    stub_written = (flash[1] == BOOT_STUB_GOTO);
+
+    data = PROTOCOL_BOOT;
+    while(data >= 0)
+    {
+        switch(data)
+        {
+            case PROTOCOL_BOOT:
+                row[0] = BOOT_READY;
+                row[1] = BOOT_MAX_BAUD;
+                send_bytes(port, row, 2);
+                break;
+
+            case BOOT_CMD_BAUD:
+                receive_byte(port, REPLY_MS);
+                row[0] = BOOT_READY;
+                send_bytes(port, row, 1);
+                break;
+
+            case BOOT_CMD_WRITE:
+                crc = 0xFFFF;
+                for(count = 0; count < (int)sizeof(row); count++)
+                {
+                    if((data = receive_byte(port, REPLY_MS)) < 0)
+                    {
+                        break;
+                    }
+                    row[count] = (uint8_t)data;
+                    if(count < (int)sizeof(row) - 2)
+                    {
+                        crc = crc16(crc, (uint8_t)data);
+                    }
+                }
+                if(data < 0)
+                {
+                    break;
+                }
+
+                address = (uint16_t)((row[0] << 8) | row[1]);
+                result  = BOOT_SKIPPED;
+                if(crc != ((row[sizeof(row) - 2] << 8) | row[sizeof(row) - 1]))
+                {
+                    result = BOOT_NAK_CRC;
+                }
+                else if((address & (BOOT_ROW_WORDS - 1)) != 0 || address >= BOOT_ADDRESS)
+                {
+                    result = BOOT_NAK_ADDRESS;
+                }
+                else
+                {
+                    for(i = 0; i < BOOT_ROW_WORDS; i++)
+                    {
+                        word = (uint16_t)(((row[2 + (i * 2) + 1] << 8) | row[2 + (i * 2)]) & ERASED_WORD);
+                        if(flash[address + i] != word)
+                        {
+                            result = BOOT_WRITTEN;
+                        }
+                    }
+                }
+                if(result == BOOT_WRITTEN)
+                {
+                    if(stub_written == 0 && address != 0)
+                    {
+                        /* Jump to the boot loader */
+                        for(i = 0; i < BOOT_ROW_WORDS; i++)
+                        {
+                            flash[i] = (i == 0) ? BOOT_STUB_MOVLP : ((i == 1) ? BOOT_STUB_GOTO : ERASED_WORD);
+                        }
+                        erased++;
+                    }
+                    for(i = 0; i < BOOT_ROW_WORDS; i++)
+                    {
+                        flash[address + i] = (uint16_t)(((row[2 + (i * 2) + 1] << 8) | row[2 + (i * 2)]) & ERASED_WORD);
+                    }
+                    erased++;
+                    stub_written = (address != 0);
+                }
+                row[0] = (uint8_t)result;
+                send_bytes(port, row, 1);
+                break;
+
+            case BOOT_CMD_EXIT:
+                row[0] = BOOT_READY;
+                send_bytes(port, row, 1);
+                fprintf(stderr, "model: %ld rows erased%s\n", erased,
+                        stub_written ? ", row 0 still jumps to the boot loader" : "");
+                return;
+        }
+        data = receive_byte(port, 5000);
+    }
+    fprintf(stderr, "model: timeout\n");
+}
+
+
+/*-----------------------------------------------------
+ * Port
+ *---------------------------------------------------*/
+static speed_t baud_speed(int code)
+{
+    switch(code)
+    {
+        case BOOT_BAUD_115200: return B115200;
+        case BOOT_BAUD_57600:  return B57600;
+        default:               return B9600;
+    }
+}
+
+static void set_speed(int port, speed_t speed)
+{
+    struct termios tio;
+
+    if(tcgetattr(port, &tio) != 0)
+    {
+        return;     // Not a tty (model)
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tio.c_cflag |= (CLOCAL | CREAD);
+    tcdrain(port);
+    tcsetattr(port, TCSANOW, &tio);
+}
+
+static int open_port(const char *device, const char *model)
+{
+    int sv[2];
+
+    if(model == NULL)
+    {
+        if((fd = open(device, O_RDWR | O_NOCTTY)) < 0)
+        {
+            perror(device);
+            exit(1);
+        }
+        set_speed(fd, B9600);
+        tcflush(fd, TCIOFLUSH);
+        return 0;
+    }
+
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    {
+        perror("socketpair");
+        exit(1);
+    }
+    if(fork() == 0)
+    {
+        close(sv[0]);
+        model_main(sv[1], model);
+        exit(0);
+    }
+    close(sv[1]);
+    fd = sv[0];
+    return 1;
+}
+
+
+/*-----------------------------------------------------
+ * Update
+ *---------------------------------------------------*/
+static int send_row(unsigned row, int retry)
+{
+    uint8_t buf[1 + 2 + (BOOT_ROW_WORDS * 2) + 2];
+    uint16_t address = (uint16_t)(row * BOOT_ROW_WORDS);
+    uint16_t crc = 0xFFFF;
+    int n = 0;
+    int reply;
+    int i;
+
+    buf[n++] = BOOT_CMD_WRITE;
+    buf[n++] = (uint8_t)(address >> 8);
+    buf[n++] = (uint8_t)address;
+    for(i = 0; i < BOOT_ROW_WORDS; i++)
+    {
+        buf[n++] = (uint8_t)image[address + i];
+        buf[n++] = (uint8_t)(image[address + i] >> 8);
+    }
+    for(i = 1; i < n; i++)
+    {
+        crc = crc16(crc, buf[i]);
+    }
+    buf[n++] = (uint8_t)(crc >> 8);
+    buf[n++] = (uint8_t)crc;
+
+    for(;;)
+    {
+        send_bytes(fd, buf, n);
+        reply = receive_byte(fd, REPLY_MS);
+        switch(reply)
+        {
+            case BOOT_WRITTEN: cnt_written++; return 0;
+            case BOOT_SKIPPED: cnt_skipped++; return 0;
+            case BOOT_NAK_ADDRESS:
+                fprintf(stderr, "row 0x%04X: address rejected\n", address);
+                return -1;
+        }
+        if(retry-- <= 0)
+        {
+            fprintf(stderr, "row 0x%04X: %s\n", address,
+                    (reply < 0) ? "no reply" : (reply == BOOT_NAK_VERIFY) ? "verify error" : "CRC error");
+            return -1;
+        }
+        cnt_retry++;
+
+        /* Lost bytes : let the boot loader finish the partial row */
+        if(reply < 0)
+        {
+            for(i = 0; i < n && receive_byte(fd, 20) < 0; i++)
+            {
+                send_bytes(fd, (const uint8_t *)"\0", 1);
+            }
+        }
+    }
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: boot_send [-D device | -M old.hex|-] [-b 0|1|2] [-r retry] image.hex\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *device = "/dev/ttyUSB0";
+    const char *model = NULL;
+    uint8_t cmd[3];
+    int baud = BOOT_BAUD_9600;
+    int retry = 3;
+    int max_baud;
+    int rows = 0;
+    double start;
+    unsigned row;
+    int opt;
+
+    while((opt = getopt(argc, argv, "D:M:b:r:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'D': device = optarg; break;
+            case 'M': model  = optarg; break;
+            case 'b': baud   = atoi(optarg); break;
+            case 'r': retry  = atoi(optarg); break;
+            default:  usage();
+        }
+    }
+    if(optind != argc - 1 || baud < BOOT_BAUD_9600 || baud > BOOT_BAUD_115200)
+    {
+        usage();
+    }
+    load_hex(argv[optind], image, image_row);
+    for(row = 0; row < BOOT_ADDRESS / BOOT_ROW_WORDS; row++)
+    {
+        rows += image_row[row];
+    }
+    for(; row < ROW_NUM; row++)
+    {
+        if(image_row[row])
+        {
+            fprintf(stderr, "%s: data at 0x%04X, boot loader area is never written\n",
+                    argv[optind], row * BOOT_ROW_WORDS);
+            return 1;
+        }
+    }
+    if(image_row[0] == 0)
+    {
+        fprintf(stderr, "%s: no reset vector\n", argv[optind]);
+        return 1;
+    }
+
+    start = now_ms();
+    if(!open_port(device, model))
+    {
+        /* Application jumps to the boot loader */
+        cmd[0] = PROTOCOL_BOOT;
+        cmd[1] = PROTOCOL_BOOT_KEY;
+        cmd[2] = (uint8_t)~PROTOCOL_BOOT_KEY;
+        send_bytes(fd, cmd, 3);
+    }
+    if(receive_byte(fd, REPLY_MS) != BOOT_READY || (max_baud = receive_byte(fd, REPLY_MS)) < 0)
+    {
+        fprintf(stderr, "no boot loader\n");
+        return 1;
+    }
+
+    /* Baudrate (9600 : nothing to change) */
+    if(baud > max_baud)
+    {
+        fprintf(stderr, "baud code %d not supported, max %d\n", baud, max_baud);
+        return 1;
+    }
+    if(baud != BOOT_BAUD_9600)
+    {
+        cmd[0] = BOOT_CMD_BAUD;
+        cmd[1] = (uint8_t)baud;
+        send_bytes(fd, cmd, 2);
+        set_speed(fd, baud_speed(baud));
+        if(receive_byte(fd, REPLY_MS) != BOOT_READY)
+        {
+            fprintf(stderr, "baudrate change failed\n");
+            return 1;
+        }
+    }
+
+    /* Row 0 last */
+    for(row = 1; row < BOOT_ADDRESS / BOOT_ROW_WORDS; row++)
+    {
+        if(image_row[row] && send_row(row, retry) != 0)
+        {
+            return 1;
+        }
+    }
+    if(send_row(0, retry) != 0)
+    {
+        return 1;
+    }
+
+    cmd[0] = BOOT_CMD_EXIT;
+    send_bytes(fd, cmd, 1);
+    receive_byte(fd, REPLY_MS);
+
+    printf("%d rows: written %ld, skipped %ld, retries %ld, %ld bytes in %.1f s\n",
+           rows, cnt_written, cnt_skipped, cnt_retry, cnt_bytes, (now_ms() - start) / 1000.0);
+
+    close(fd);
+    if(model != NULL)
+    {
+        wait(NULL);
+    }
+    return 0;
+}
@@ -0,0 +1,849 @@
+/*
+ * bus_sim : Multi-drop bus simulator for sizing multi-door installs
+ *
+ * Models N door units and one handset on the 9bit multi-drop bus
+ * (USART_MULTIDROP = 1). Each door follows call_sequence() of main.c:
+ *
+ *   press -> 100ms debounce -> notify -> call message redraw
+ *         -> wait for response (20s timeout)
+ *         -> response / not here message -> 20s hold -> default message
+ *
+ * Notification uses the carrier sense, ACK and backoff of usart_notify()
+ * with the timing in protocol.h. Presses during a call are merged into it
+ * by call_manager.c and counted as merged here.
+ *
+ * Besides the notification, the frames each door sends on its own are on
+ * the bus too (every frame after the carrier sense of usart_begin_frame()):
+ *
+ *   PROTOCOL_PING        heartbeat of link.c, every LINK_HEARTBEAT_MS after
+ *                        the reply, at once after a reply lost within the
+ *                        RTO (LINK_MISS_MAX in a row : link down, no call is
+ *                        notified), and as a probe after each notification.
+ *                        The handset replies PROTOCOL_PONG.
+ *   PROTOCOL_CALL_UPDATE press count of merged presses, every CALL_UPDATE_MS
+ *                        at most while waiting for the response (main.c)
+ *
+ * The RTO is LINK_RTO_INIT_MS until the first reply, then LINK_RTO_MIN_MS
+ * (RTT on the bus is a few ms). Doors start the heartbeat at random within
+ * LINK_HEARTBEAT_MS (power on is not simultaneous).
+ *
+ * This is a model written from main.c, link.c and usart.c, not the
+ * firmware: it does not run their code, so keep it in step when the frames
+ * or their timing change.
+ *
+ * Build:
+ *     cc -O2 -Wall -I. -o bus_sim tools/bus_sim.c -lm
+ *
+ * Usage:
+ *     bus_sim [-n units] [-b baud] [-l latency_us] [-e byte_error_rate]
+ *             [-r calls_per_hour_per_unit] [-t seconds] [-d redraw_ms]
+ *             [-a answer_ms] [-p answer_probability] [-s seed]
+ *             [-f script]
+ *
+ *     script : one press per line, "<time_ms> <unit>" (unit = 1 ... N).
+ *              Random traffic (-r) is not generated when a script is given.
+ *
+ * Output: press -> handset display latency percentiles and event counts.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include "protocol.h"
+#include "link.h"
+#include "call_manager.h"
+
+
+/* Door Timing (main.c) */
+#define DEBOUNCE_US        (100000LL)
+#define RESPONSE_US        (20000000LL)
+#define HOLD_US            (20000000LL)
+
+/* Handset */
+#define HANDSET_TURN_US    (1000LL)     // Reception -> ACK
+
+/* Limits */
+#define UNIT_MAX           (254)
+#define EVENT_MAX          (1 << 16)
+#define TX_MAX             (1 << 12)
+#define SAMPLE_MAX         (1 << 20)
+
+#define MS(x)              ((int64_t)(x) * 1000LL)
+
+
+/* Event Type */
+typedef enum
+{
+    EV_PRESS,
+    EV_NOTIFY,          // Debounce done (or backoff), start notify
+    EV_SENSE,           // Carrier sense (1ms step)
+    EV_TX_END,
+    EV_ACK_TIMEOUT,
+    EV_READY,           // Call message drawn, response is taken
+    EV_RESPONSE_TIMEOUT,
+    EV_HOLD_END,
+    EV_ANSWER,          // Handset sends response
+    EV_UPDATE,          // TIMER_CALL_UPDATE of main.c
+    EV_PING,            // TIMER_LINK of link.c (heartbeat or RTO), arg : ping_seq
+    EV_FRAME_SENSE,     // Carrier sense of a PING / CALL_UPDATE (1ms step), arg 1 : frame end
+    EV_PONG,            // Handset sends PONG
+} event_type_t;
+
+typedef struct
+{
+    int64_t      time;
+    event_type_t type;
+    int          unit;      // 0 : handset
+    int          arg;
+    unsigned     token;
+} event_t;
+
+/* Door State */
+typedef enum
+{
+    DOOR_IDLE,
+    DOOR_BUSY,          // Debounce
+    DOOR_NOTIFY,        // Carrier sense, TX, ACK wait, backoff
+    DOOR_WAIT,          // Waiting for response
+    DOOR_HOLD,
+} door_state_t;
+
+typedef struct
+{
+    door_state_t state;
+    unsigned     token;
+    int64_t      press_time;
+    int          retry;
+    int          idle_ms;
+    int          ready;         // Call message drawn
+    int          delivered;     // Handset displayed this call
+    int          response;      // Response received during redraw
+    int          presses;       // Merged presses not sent by CALL_UPDATE
+
+    /* link.c */
+    int          link_up;
+    int          ping_pending;
+    int          ping_seq;      // Older EV_PING are stale
+    int          misses;
+    int64_t      rto_us;
+
+    /* Frames other than the notification */
+    int          want_ping;
+    int          want_update;
+    int          tx_sensing;
+    int          tx_idle_ms;
+} door_t;
+
+/* Transmission on the bus */
+typedef struct
+{
+    int64_t start;
+    int64_t end;
+    int     sender;     // 0 : handset
+    int     dest;       // 0 : handset
+    int     data;
+    int     broken;     // Collision or noise
+} tx_t;
+
+
+/* Parameters */
+static int     unit_num    = 4;
+static int     baud        = 9600;
+static int64_t latency_us  = 50;
+static double  error_rate  = 0.0;
+static double  call_rate   = 6.0;      // per hour per unit
+static int64_t duration_us = MS(3600 * 1000LL);
+static int64_t redraw_us   = MS(40);
+static int64_t answer_us   = MS(5000);
+static double  answer_prob = 0.8;
+
+/* State */
+static event_t heap[EVENT_MAX];
+static int     heap_num;
+static door_t  door[UNIT_MAX + 1];
+static tx_t    tx[TX_MAX];       // Ring, indexed by id % TX_MAX
+static long    tx_first;         // Oldest id which can still overlap
+static long    tx_next;
+static int64_t now;
+static int64_t byte_us;
+
+/* Results */
+static double  *sample;
+static int     sample_num;
+static long    cnt_press, cnt_merge, cnt_call, cnt_fail, cnt_retry;
+static long    cnt_collision, cnt_noise, cnt_answer, cnt_timeout;
+static long    cnt_ping, cnt_ping_lost, cnt_link_down, cnt_link_fail;
+static long    cnt_update, cnt_update_rx;
+static int64_t bus_busy_us;
+
+
+/*-----------------------------------------------------
+ * Event Queue (binary heap)
+ *---------------------------------------------------*/
+static void push(int64_t time, event_type_t type, int unit, int arg)
+{
+    int i = heap_num++;
+    event_t ev = {time, type, unit, arg, (unit > 0) ? door[unit].token : 0};
+
+    if(heap_num > EVENT_MAX)
+    {
+        fprintf(stderr, "event queue overflow\n");
+        exit(1);
+    }
+    while(i > 0 && heap[(i - 1) / 2].time > time)
+    {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = ev;
+}
+
+static event_t pop(void)
+{
+    event_t top = heap[0];
+    event_t last = heap[--heap_num];
+    int i = 0;
+    int c;
+
+    while((c = 2 * i + 1) < heap_num)
+    {
+        if(c + 1 < heap_num && heap[c + 1].time < heap[c].time)
+        {
+            c++;
+        }
+        if(heap[c].time >= last.time)
+        {
+            break;
+        }
+        heap[i] = heap[c];
+        i = c;
+    }
+    heap[i] = last;
+
+    return top;
+}
+
+
+/*-----------------------------------------------------
+ * Bus
+ *---------------------------------------------------*/
+static double uniform(void)
+{
+    return (rand() + 0.5) / ((double)RAND_MAX + 1.0);
+}
+
+/* Bus seen busy by "who" at now (signal arrives after latency) */
+static int bus_busy(int who)
+{
+    long id;
+    tx_t *t;
+
+    for(id = tx_first; id < tx_next; id++)
+    {
+        t = &tx[id % TX_MAX];
+        if(t->sender != who && t->start + latency_us <= now && now < t->end + latency_us)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Forget transmissions which can not overlap anymore */
+static void bus_compact(void)
+{
+    while(tx_first < tx_next && tx[tx_first % TX_MAX].end + 2 * latency_us + MS(1000) < now)
+    {
+        tx_first++;
+    }
+}
+
+static void bus_send(int sender, int dest, int data, int bytes)
+{
+    tx_t *p;
+    long id;
+    int i;
+
+    bus_compact();
+    if(tx_next - tx_first == TX_MAX)
+    {
+        fprintf(stderr, "transmission table overflow\n");
+        exit(1);
+    }
+
+    p = &tx[tx_next % TX_MAX];
+    p->start  = now;
+    p->end    = now + bytes * byte_us;
+    p->sender = sender;
+    p->dest   = dest;
+    p->data   = data;
+    p->broken = 0;
+
+    /* Collision with any overlapping transmission */
+    for(id = tx_first; id < tx_next; id++)
+    {
+        tx_t *t = &tx[id % TX_MAX];
+
+        if(t->start < p->end + latency_us && p->start < t->end + latency_us)
+        {
+            if(!t->broken)
+            {
+                cnt_collision++;
+            }
+            t->broken = 1;
+            p->broken = 1;
+        }
+    }
+
+    /* Noise */
+    for(i = 0; i < bytes; i++)
+    {
+        if(uniform() < error_rate)
+        {
+            if(!p->broken)
+            {
+                cnt_noise++;
+            }
+            p->broken = 1;
+        }
+    }
+
+    bus_busy_us += p->end - p->start;
+    push(p->end + latency_us, EV_TX_END, sender, (int)(tx_next % TX_MAX));
+    tx_next++;
+}
+
+
+/*-----------------------------------------------------
+ * Door Unit
+ *---------------------------------------------------*/
+static void door_set(int unit, door_state_t state)
+{
+    door[unit].state = state;
+    door[unit].token++;
+}
+
+static void door_hold(int unit)
+{
+    door_set(unit, DOOR_HOLD);
+    push(now + redraw_us + HOLD_US + redraw_us, EV_HOLD_END, unit, 0);
+}
+
+static void door_start_notify(int unit)
+{
+    door[unit].idle_ms = 0;
+    push(now, EV_SENSE, unit, 0);
+}
+
+/* Start carrier sense of a PING / CALL_UPDATE (main loop is blocked in usart_notify()) */
+static void door_kick_tx(int unit)
+{
+    door_t *d = &door[unit];
+
+    if(d->tx_sensing || d->state == DOOR_NOTIFY || !(d->want_ping || d->want_update))
+    {
+        return;
+    }
+    d->tx_sensing = 1;
+    d->tx_idle_ms = 0;
+    push(now, EV_FRAME_SENSE, unit, 0);
+}
+
+/* send_ping() of link.c */
+static void door_ping(int unit)
+{
+    door[unit].want_ping = 1;
+    door_kick_tx(unit);
+}
+
+/* link_probe() of link.c */
+static void door_probe(int unit)
+{
+    if(door[unit].ping_pending == 0 && door[unit].want_ping == 0)
+    {
+        door[unit].misses = 0;
+        door_ping(unit);
+    }
+}
+
+/* Events of link.c and of the frame transmission, not bound to the call state */
+static void link_event(const event_t *ev)
+{
+    door_t *d = &door[ev->unit];
+
+    switch(ev->type)
+    {
+        case EV_PING:
+            if(ev->arg != d->ping_seq)
+            {
+                break;
+            }
+            if(d->ping_pending)
+            {
+                /* No reply within RTO */
+                d->ping_pending = 0;
+                cnt_ping_lost++;
+                if(d->misses < LINK_MISS_MAX)
+                {
+                    d->misses++;
+                }
+                if(d->misses < LINK_MISS_MAX)
+                {
+                    door_ping(ev->unit);
+                    break;
+                }
+                if(d->link_up)
+                {
+                    cnt_link_down++;
+                }
+                d->link_up = 0;
+                push(now + MS(LINK_HEARTBEAT_MS), EV_PING, ev->unit, ++d->ping_seq);
+                break;
+            }
+            door_ping(ev->unit);
+            break;
+
+        case EV_FRAME_SENSE:
+            if(ev->arg)
+            {
+                /* usart_end_frame() : next frame */
+                d->tx_sensing = 0;
+                door_kick_tx(ev->unit);
+                break;
+            }
+            if(d->tx_idle_ms < PROTOCOL_BUS_IDLE_MS)
+            {
+                d->tx_idle_ms = bus_busy(ev->unit) ? 0 : d->tx_idle_ms + 1;
+                push(now + MS(1), EV_FRAME_SENSE, ev->unit, 0);
+                break;
+            }
+            if(d->want_ping)
+            {
+                /* Address, own address, PING */
+                d->want_ping    = 0;
+                d->ping_pending = 1;
+                cnt_ping++;
+                bus_send(ev->unit, PROTOCOL_HANDSET_ADDRESS, PROTOCOL_PING, 3);
+                push(now + 3 * byte_us + d->rto_us, EV_PING, ev->unit, ++d->ping_seq);
+                push(now + 3 * byte_us, EV_FRAME_SENSE, ev->unit, 1);
+            }
+            else
+            {
+                /* Address, own address, CALL_UPDATE, button, presses */
+                d->want_update = 0;
+                cnt_update++;
+                bus_send(ev->unit, PROTOCOL_HANDSET_ADDRESS, PROTOCOL_CALL_UPDATE, 5);
+                push(now + 5 * byte_us, EV_FRAME_SENSE, ev->unit, 1);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void door_event(const event_t *ev)
+{
+    door_t *d = &door[ev->unit];
+
+    switch(ev->type)
+    {
+        case EV_PRESS:
+            cnt_press++;
+            if(d->state != DOOR_IDLE)
+            {
+                cnt_merge++;
+                if(d->state != DOOR_HOLD)
+                {
+                    d->presses++;
+                }
+                break;
+            }
+            cnt_call++;
+            door_set(ev->unit, DOOR_BUSY);
+            d->press_time = now;
+            d->retry      = 0;
+            d->delivered  = 0;
+            d->response   = 0;
+            d->presses    = 0;
+            push(now + DEBOUNCE_US, EV_NOTIFY, ev->unit, 0);
+            break;
+
+        case EV_NOTIFY:
+            if(d->tx_sensing)
+            {
+                /* Main loop is still sending a PING / CALL_UPDATE */
+                push(now + MS(1), EV_NOTIFY, ev->unit, 0);
+                break;
+            }
+            if(!d->link_up)
+            {
+                /* Handset is known to be lost : not here message at once */
+                cnt_link_fail++;
+                door_probe(ev->unit);
+                door_hold(ev->unit);
+                break;
+            }
+            door_set(ev->unit, DOOR_NOTIFY);
+            door_start_notify(ev->unit);
+            break;
+
+        case EV_SENSE:
+            /* wait_bus_idle() : check RCIDL, then wait 1ms */
+            if(d->idle_ms < PROTOCOL_BUS_IDLE_MS)
+            {
+                d->idle_ms = bus_busy(ev->unit) ? 0 : d->idle_ms + 1;
+                push(now + MS(1), EV_SENSE, ev->unit, 0);
+                break;
+            }
+            bus_send(ev->unit, PROTOCOL_HANDSET_ADDRESS, PROTOCOL_CALL, 3);
+            push(now + 3 * byte_us + MS(PROTOCOL_ACK_TIMEOUT_MS), EV_ACK_TIMEOUT, ev->unit, 0);
+            break;
+
+        case EV_ACK_TIMEOUT:
+            d->retry++;
+            if(d->retry < PROTOCOL_NOTIFY_RETRY)
+            {
+                cnt_retry++;
+                push(now + MS(PROTOCOL_BACKOFF_SLOT_MS) * d->retry * ((ev->unit & 0x07) + 1),
+                     EV_NOTIFY, ev->unit, 0);
+                break;
+            }
+            /* No ACK : not here message without waiting */
+            cnt_fail++;
+            door_hold(ev->unit);
+            door_probe(ev->unit);
+            break;
+
+        case EV_READY:
+            if(d->response)
+            {
+                door_hold(ev->unit);
+                break;
+            }
+            d->ready = 1;
+            break;
+
+        case EV_RESPONSE_TIMEOUT:
+            cnt_timeout++;
+            door_hold(ev->unit);
+            break;
+
+        case EV_HOLD_END:
+            door_set(ev->unit, DOOR_IDLE);
+            break;
+
+        case EV_UPDATE:
+            /* call_update() : only a changed press count is sent */
+            if(d->link_up && d->presses > 0)
+            {
+                d->presses     = 0;
+                d->want_update = 1;
+                door_kick_tx(ev->unit);
+            }
+            push(now + MS(CALL_UPDATE_MS), EV_UPDATE, ev->unit, 0);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* Frame from handset arrived at door */
+static void door_receive(int unit, int data)
+{
+    door_t *d = &door[unit];
+
+    if(data == PROTOCOL_PONG)
+    {
+        /* link_receive() : late reply after the RTO is not a sample */
+        if(d->ping_pending)
+        {
+            d->ping_pending = 0;
+            d->rto_us       = MS(LINK_RTO_MIN_MS);
+            push(now + MS(LINK_HEARTBEAT_MS), EV_PING, unit, ++d->ping_seq);
+        }
+        d->misses  = 0;
+        d->link_up = 1;
+    }
+    else if(data == PROTOCOL_ACK && d->state == DOOR_NOTIFY)
+    {
+        /* Call message is drawn after the notification */
+        door_set(unit, DOOR_WAIT);
+        d->ready = 0;
+        push(now + redraw_us, EV_READY, unit, 0);
+        push(now + RESPONSE_US, EV_RESPONSE_TIMEOUT, unit, 0);
+        push(now + MS(CALL_UPDATE_MS), EV_UPDATE, unit, 0);
+
+        /* Frames held during usart_notify(), then link_probe() */
+        door_kick_tx(unit);
+        door_probe(unit);
+    }
+    else if(data != PROTOCOL_ACK && d->state == DOOR_WAIT)
+    {
+        if(d->ready)
+        {
+            door_hold(unit);
+        }
+        else
+        {
+            d->response = 1;
+        }
+    }
+}
+
+
+/*-----------------------------------------------------
+ * Handset
+ *---------------------------------------------------*/
+static void handset_receive(int unit, int data)
+{
+    door_t *d = &door[unit];
+
+    if(data == PROTOCOL_PING)
+    {
+        push(now + HANDSET_TURN_US, EV_PONG, 0, unit);
+        return;
+    }
+    if(data == PROTOCOL_CALL_UPDATE)
+    {
+        cnt_update_rx++;
+        return;
+    }
+
+    /* Display call (first delivery only, retries are duplicates) */
+    if(!d->delivered)
+    {
+        d->delivered = 1;
+        if(sample_num < SAMPLE_MAX)
+        {
+            sample[sample_num++] = (now - d->press_time) / 1000.0;
+        }
+        if(uniform() < answer_prob)
+        {
+            push(now + (int64_t)(-log(uniform()) * answer_us), EV_ANSWER, 0, unit);
+        }
+    }
+
+    /* ACK every copy (the door may have missed the previous ACK) */
+    push(now + HANDSET_TURN_US, EV_ANSWER, 0, -unit);
+}
+
+static void handset_event(const event_t *ev)
+{
+    int unit = (ev->arg < 0) ? -ev->arg : ev->arg;
+
+    /* Handset waits for idle bus too */
+    if(bus_busy(0))
+    {
+        push(now + MS(1), ev->type, 0, ev->arg);
+        return;
+    }
+
+    if(ev->type == EV_PONG)
+    {
+        bus_send(0, unit, PROTOCOL_PONG, 2);
+    }
+    else if(ev->arg < 0)
+    {
+        bus_send(0, unit, PROTOCOL_ACK, 2);
+    }
+    else
+    {
+        cnt_answer++;
+        bus_send(0, unit, PROTOCOL_RESPONCE1, 2);
+    }
+}
+
+
+/*-----------------------------------------------------
+ * Main
+ *---------------------------------------------------*/
+static int compare(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static double percentile(double p)
+{
+    int i;
+
+    if(sample_num == 0)
+    {
+        return 0.0;
+    }
+    i = (int)ceil(p / 100.0 * sample_num) - 1;
+    if(i < 0)
+    {
+        i = 0;
+    }
+    return sample[i];
+}
+
+static void load_script(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    double time_ms;
+    int unit;
+
+    if(fp == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+    while(fscanf(fp, "%lf %d", &time_ms, &unit) == 2)
+    {
+        if(unit < 1 || unit > unit_num)
+        {
+            fprintf(stderr, "%s: unit %d out of range\n", path, unit);
+            exit(1);
+        }
+        push((int64_t)(time_ms * 1000.0), EV_PRESS, unit, 0);
+    }
+    fclose(fp);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: bus_sim [-n units] [-b baud] [-l latency_us] [-e byte_error_rate]\n"
+        "               [-r calls_per_hour_per_unit] [-t seconds] [-d redraw_ms]\n"
+        "               [-a answer_ms] [-p answer_probability] [-s seed] [-f script]\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *script = NULL;
+    unsigned seed = 1;
+    event_t ev;
+    int opt;
+    int i;
+
+    while((opt = getopt(argc, argv, "n:b:l:e:r:t:d:a:p:s:f:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'n': unit_num    = atoi(optarg); break;
+            case 'b': baud        = atoi(optarg); break;
+            case 'l': latency_us  = atoll(optarg); break;
+            case 'e': error_rate  = atof(optarg); break;
+            case 'r': call_rate   = atof(optarg); break;
+            case 't': duration_us = MS(atof(optarg) * 1000.0); break;
+            case 'd': redraw_us   = MS(atof(optarg)); break;
+            case 'a': answer_us   = MS(atof(optarg)); break;
+            case 'p': answer_prob = atof(optarg); break;
+            case 's': seed        = (unsigned)atoi(optarg); break;
+            case 'f': script      = optarg; break;
+            default:  usage();
+        }
+    }
+    if(unit_num < 1 || unit_num > UNIT_MAX || baud <= 0)
+    {
+        usage();
+    }
+
+    srand(seed);
+    byte_us = (11 * 1000000LL) / baud;     // Start + 8 + 9th + Stop
+    sample  = malloc(sizeof(double) * SAMPLE_MAX);
+
+    /* Heartbeat (link_init()) */
+    for(i = 1; i <= unit_num; i++)
+    {
+        door[i].link_up = 1;
+        door[i].rto_us  = MS(LINK_RTO_INIT_MS);
+        push((int64_t)(uniform() * MS(LINK_HEARTBEAT_MS)), EV_PING, i, 0);
+    }
+
+    /* Traffic */
+    if(script != NULL)
+    {
+        load_script(script);
+    }
+    else if(call_rate > 0.0)
+    {
+        for(i = 1; i <= unit_num; i++)
+        {
+            push((int64_t)(-log(uniform()) * 3600e6 / call_rate), EV_PRESS, i, 0);
+        }
+    }
+
+    /* Run */
+    while(heap_num > 0)
+    {
+        ev = pop();
+        if(ev.time > duration_us)
+        {
+            break;
+        }
+        now = ev.time;
+
+        if(ev.type == EV_TX_END)
+        {
+            tx_t t = tx[ev.arg];
+
+            if(t.broken)
+            {
+                ;
+            }
+            else if(t.dest == PROTOCOL_HANDSET_ADDRESS)
+            {
+                handset_receive(t.sender, t.data);
+            }
+            else
+            {
+                door_receive(t.dest, t.data);
+            }
+            continue;
+        }
+
+        if(ev.type == EV_ANSWER || ev.type == EV_PONG)
+        {
+            handset_event(&ev);
+            continue;
+        }
+        if(ev.type == EV_PING || ev.type == EV_FRAME_SENSE)
+        {
+            link_event(&ev);
+            continue;
+        }
+
+        /* Stale timer of a door */
+        if(ev.type != EV_PRESS && ev.token != door[ev.unit].token)
+        {
+            continue;
+        }
+        door_event(&ev);
+
+        /* Next random press of this unit */
+        if(ev.type == EV_PRESS && script == NULL)
+        {
+            push(now + (int64_t)(-log(uniform()) * 3600e6 / call_rate), EV_PRESS, ev.unit, 0);
+        }
+    }
+
+    /* Report */
+    qsort(sample, sample_num, sizeof(double), compare);
+    printf("units %d, baud %d, latency %lldus, byte error %g, %.0fs\n",
+           unit_num, baud, (long long)latency_us, error_rate, duration_us / 1e6);
+    printf("press -> handset display [ms] (%d calls)\n", sample_num);
+    printf("  p50 %8.1f\n  p90 %8.1f\n  p99 %8.1f\n  max %8.1f\n",
+           percentile(50), percentile(90), percentile(99),
+           sample_num ? sample[sample_num - 1] : 0.0);
+    printf("presses %ld, calls %ld, merged (busy) %ld, notify failed %ld\n",
+           cnt_press, cnt_call, cnt_merge, cnt_fail);
+    printf("retries %ld, collisions %ld, noise %ld, answered %ld, timeout %ld\n",
+           cnt_retry, cnt_collision, cnt_noise, cnt_answer, cnt_timeout);
+    printf("pings %ld, lost %ld, link down %ld, calls on a down link %ld\n",
+           cnt_ping, cnt_ping_lost, cnt_link_down, cnt_link_fail);
+    printf("call updates %ld, received %ld\n", cnt_update, cnt_update_rx);
+    printf("bus utilization %.3f%%\n", 100.0 * bus_busy_us / (double)duration_us);
+
+    free(sample);
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * clock_model : Energy and latency of the clock modes of pic_clock.c
+ *
+ * Host model of clock_set_mode() with the frequencies of pic_clock.h and
+ * the typical supply current of each oscillator (PIC16F1938 datasheet,
+ * VDD 3.0V, 25C; override with -I for the part on the board). Reports
+ *
+ *   - per mode : Fosc, current, energy per instruction cycle, and the
+ *     latency of a switch into the mode (USART idle waits of
+ *     clock_set_mode() at the old clock, then oscillator start)
+ *   - one redraw (-r instruction cycles; CPU and display bus both scale
+ *     with Fosc) run in each mode, with the switch from and back to
+ *     CLOCK_MODE_IDLE
+ *   - average current over a day of -c calls (each one redraw in
+ *     CLOCK_MODE_FAST and a UART burst in CLOCK_MODE_FULL) against a unit
+ *     that stays in CLOCK_MODE_FULL, as before the clock switching
+ *
+ * The model is not the firmware: the oscillator start times are the
+ * datasheet figures, and the USART waits are the worst case (a byte in
+ * transmission and a byte in reception).
+ *
+ * Build:
+ *     cc -O2 -Wall -I. -o clock_model tools/clock_model.c
+ *
+ * Usage:
+ *     clock_model [-r redraw_cycles] [-u burst_ms] [-c calls_per_day]
+ *                 [-I idle_mA,full_mA,fast_mA] [-V vdd]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "pic_clock.h"
+#include "usart.h"
+
+
+/* usart.c */
+#define BYTE_US             (10 * 1e6 / BAUDRATE)   // 8N1
+#define RX_IDLE_POLL_CYCLES (6)                     // usart_wait_rx_idle() loop
+
+
+/* Mode Parameters */
+typedef struct
+{
+    const char *name;
+    double fosc;            // [Hz]
+    double idd_ma;          // Typical supply current
+    double start_us;        // Oscillator ready (MFIOFR / OSTS / HFIOFR)
+} mode_param_t;
+
+static mode_param_t mode[] =
+{
+    {"IDLE", CLOCK_FREQ_IDLE, 0.25,    2.0},    // MFINTOSC
+    {"FULL", CLOCK_FREQ_FULL, 1.40, 1100.0},    // Crystal start + OST (1024 Tosc)
+    {"FAST", CLOCK_FREQ_FAST, 2.10,    5.0},    // HFINTOSC
+};
+#define MODE_NUM    (sizeof(mode) / sizeof(mode[0]))
+
+
+/*-----------------------------------------------------
+ * Latency of clock_set_mode(to) called in mode from
+ *---------------------------------------------------*/
+static double switch_us(int from, int to)
+{
+    double rx_bound_us = USART_RX_IDLE_POLLS * RX_IDLE_POLL_CYCLES * 4e6 / mode[from].fosc;
+    double rx_us       = (rx_bound_us < BYTE_US) ? rx_bound_us : BYTE_US;
+
+    if(from == to)
+    {
+        return 0.0;
+    }
+    return BYTE_US + rx_us + mode[to].start_us;
+}
+
+/* [uJ] of t_us in mode m */
+static double energy_uj(int m, double t_us, double vdd)
+{
+    return mode[m].idd_ma * vdd * t_us / 1000.0;
+}
+
+/* Time [us] of n instruction cycles in mode m */
+static double cycles_us(int m, double cycles)
+{
+    return cycles * 4e6 / mode[m].fosc;
+}
+
+
+int main(int argc, char *argv[])
+{
+    double redraw_cycles = 250000;
+    double burst_ms = 50;
+    double calls = 20;
+    double vdd = 3.0;
+    double t_in, t_run, t_out, e, t_busy_fast, t_busy_full, t_idle, avg_switch, avg_full;
+    int opt;
+    size_t m;
+
+    while((opt = getopt(argc, argv, "r:u:c:I:V:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'r': redraw_cycles = atof(optarg); break;
+            case 'u': burst_ms      = atof(optarg); break;
+            case 'c': calls         = atof(optarg); break;
+            case 'V': vdd           = atof(optarg); break;
+            case 'I':
+                if(sscanf(optarg, "%lf,%lf,%lf", &mode[0].idd_ma, &mode[1].idd_ma, &mode[2].idd_ma) != 3)
+                {
+                    fprintf(stderr, "-I idle_mA,full_mA,fast_mA\n");
+                    return 1;
+                }
+                break;
+            default:
+                fprintf(stderr, "usage: clock_model [-r redraw_cycles] [-u burst_ms] [-c calls_per_day]\n"
+                                "                   [-I idle_mA,full_mA,fast_mA] [-V vdd]\n");
+                return 1;
+        }
+    }
+
+    printf("mode   Fosc[MHz]  IDD[mA]  nJ/cycle  switch in from IDLE / FULL / FAST [us]\n");
+    for(m = 0; m < MODE_NUM; m++)
+    {
+        printf("%-5s  %9.1f  %7.2f  %8.2f  %8.0f / %6.0f / %6.0f\n",
+               mode[m].name, mode[m].fosc / 1e6, mode[m].idd_ma,
+               energy_uj((int)m, cycles_us((int)m, 1), vdd) * 1000.0,
+               switch_us(0, (int)m), switch_us(1, (int)m), switch_us(2, (int)m));
+    }
+
+    printf("\nredraw of %.0f cycles from IDLE\n", redraw_cycles);
+    printf("mode   switch[ms]  redraw[ms]  back[ms]  total[ms]  energy[uJ]\n");
+    for(m = 0; m < MODE_NUM; m++)
+    {
+        t_in  = switch_us(0, (int)m);
+        t_run = cycles_us((int)m, redraw_cycles);
+        t_out = switch_us((int)m, 0);
+
+        /* Switch waits run at the old clock */
+        e = energy_uj(0, t_in, vdd) + energy_uj((int)m, t_run + t_out, vdd);
+        printf("%-5s  %10.2f  %10.2f  %8.2f  %9.2f  %10.1f\n", mode[m].name,
+               t_in / 1000.0, t_run / 1000.0, t_out / 1000.0, (t_in + t_run + t_out) / 1000.0, e);
+    }
+
+    /* Day : calls x (redraw in FAST, burst in FULL), rest in IDLE */
+    t_busy_fast = calls * (switch_us(0, 2) + cycles_us(2, redraw_cycles) + switch_us(2, 0));
+    t_busy_full = calls * (switch_us(0, 1) + burst_ms * 1000.0 + switch_us(1, 0));
+    t_idle      = 86400e6 - t_busy_fast - t_busy_full;
+    avg_switch  = (energy_uj(2, t_busy_fast, vdd) + energy_uj(1, t_busy_full, vdd) + energy_uj(0, t_idle, vdd)) /
+                  (vdd * 86400e6) * 1000.0;
+    avg_full    = mode[1].idd_ma;
+
+    printf("\nday of %.0f calls (redraw in FAST, %.0f ms UART burst in FULL)\n", calls, burst_ms);
+    printf("  average current %.4f mA with clock switching, %.4f mA in FULL only (%.1f x)\n",
+           avg_switch, avg_full, avg_full / avg_switch);
+    printf("  redraw %.2f ms in FAST, %.2f ms in FULL\n",
+           (switch_us(0, 2) + cycles_us(2, redraw_cycles)) / 1000.0, cycles_us(1, redraw_cycles) / 1000.0);
+
+    return 0;
+}
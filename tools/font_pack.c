@@ -0,0 +1,316 @@
+/*
+ * font_pack : Font image for the font flash of the door unit
+ *
+ * Converts an 8x8 dot BDF font with JIS X 0208 encodings (e.g. Misaki
+ * font) into the image read by font.c, and checks an image without the
+ * door unit:
+ *
+ *   font_pack -o font.bin misaki_gothic.bdf     build image (write it to
+ *                                               the serial flash with a
+ *                                               flash programmer)
+ *   font_pack -i font.bin -s 2422 2423 ...      print glyphs as text
+ *   font_pack -i font.bin -c codes.txt          glyph cache hit rate of
+ *                                               a text, one line of hex
+ *                                               JIS codes per display line
+ *
+ * Image layout and cache policy are those of font.h / font.c.
+ *
+ * Build:
+ *     cc -O2 -Wall -o font_pack tools/font_pack.c
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/* font.h */
+#define FONT_HEADER_BYTES   (4)
+#define FONT_GLYPH_BYTES    (8)
+#define FONT_GLYPH_NUM      (94 * 94)
+#define FONT_JIS_MIN        (0x21)
+#define FONT_JIS_MAX        (0x7E)
+#define FONT_CACHE_NUM      (16)
+#define FONT_LINE_CHARS     (12)
+
+#define IMAGE_BYTES (FONT_HEADER_BYTES + FONT_GLYPH_NUM * FONT_GLYPH_BYTES)
+
+
+static uint8_t image[IMAGE_BYTES];
+
+
+/*-----------------------------------------------------
+ * Image
+ *---------------------------------------------------*/
+static long glyph_offset(unsigned jis)
+{
+    unsigned hi = jis >> 8;
+    unsigned lo = jis & 0xFF;
+
+    if(hi < FONT_JIS_MIN || hi > FONT_JIS_MAX || lo < FONT_JIS_MIN || lo > FONT_JIS_MAX)
+    {
+        return -1;
+    }
+    return FONT_HEADER_BYTES + (long)((hi - FONT_JIS_MIN) * 94 + (lo - FONT_JIS_MIN)) * FONT_GLYPH_BYTES;
+}
+
+/* Rows of BDF (bit7 : left) -> columns of graphic mode (bit0 : top) */
+static int pack_bdf(const char *name)
+{
+    FILE *fp;
+    char line[256];
+    unsigned row[8];
+    int rows = -1;
+    int bbx_w = 8, bbx_h = 8, bbx_x = 0, bbx_y = 0;
+    int ascent = 7;
+    int count = 0;
+    long offset = -1;
+    int top;
+    int c, r;
+
+    if((fp = fopen(name, "r")) == NULL)
+    {
+        perror(name);
+        exit(1);
+    }
+    while(fgets(line, sizeof(line), fp) != NULL)
+    {
+        if(sscanf(line, "FONT_ASCENT %d", &ascent) == 1)
+        {
+            continue;
+        }
+        if(strncmp(line, "ENCODING ", 9) == 0)
+        {
+            offset = glyph_offset((unsigned)atoi(line + 9));
+        }
+        else if(sscanf(line, "BBX %d %d %d %d", &bbx_w, &bbx_h, &bbx_x, &bbx_y) == 4)
+        {
+            ;
+        }
+        else if(strncmp(line, "BITMAP", 6) == 0)
+        {
+            rows = 0;
+            memset(row, 0, sizeof(row));
+        }
+        else if(strncmp(line, "ENDCHAR", 7) == 0)
+        {
+            if(offset >= 0)
+            {
+                /* Align the box to the 8 dot cell */
+                top = ascent - bbx_h - bbx_y;
+                for(c = 0; c < FONT_GLYPH_BYTES; c++)
+                {
+                    uint8_t column = 0;
+
+                    for(r = 0; r < rows; r++)
+                    {
+                        if(top + r >= 0 && top + r < 8 && c - bbx_x >= 0 && c - bbx_x < 8 &&
+                           (row[r] & (0x80 >> (c - bbx_x))))
+                        {
+                            column |= (uint8_t)(1 << (top + r));
+                        }
+                    }
+                    image[offset + c] = column;
+                }
+                count++;
+            }
+            rows   = -1;
+            offset = -1;
+        }
+        else if(rows >= 0 && rows < 8)
+        {
+            row[rows++] = (unsigned)strtoul(line, NULL, 16) >> ((bbx_w > 8) ? 8 : 0);
+        }
+    }
+    fclose(fp);
+    return count;
+}
+
+static void load_image(const char *name)
+{
+    FILE *fp;
+
+    if((fp = fopen(name, "rb")) == NULL || fread(image, 1, IMAGE_BYTES, fp) != IMAGE_BYTES)
+    {
+        fprintf(stderr, "%s: not a font image\n", name);
+        exit(1);
+    }
+    fclose(fp);
+    if(image[0] != 'J' || image[1] != 'F' || image[2] != FONT_GLYPH_BYTES)
+    {
+        fprintf(stderr, "%s: bad header\n", name);
+        exit(1);
+    }
+}
+
+
+/*-----------------------------------------------------
+ * Check
+ *---------------------------------------------------*/
+static void show(unsigned jis)
+{
+    long offset = glyph_offset(jis);
+    int c, r;
+
+    printf("%04X\n", jis);
+    if(offset < 0)
+    {
+        printf("  (out of range)\n");
+        return;
+    }
+    for(r = 0; r < 8; r++)
+    {
+        printf("  ");
+        for(c = 0; c < FONT_GLYPH_BYTES; c++)
+        {
+            putchar((image[offset + c] & (1 << r)) ? '#' : '.');
+        }
+        putchar('\n');
+    }
+}
+
+/* LRU of font.c, per display line as font_write_text() */
+static void cache_run(const char *name)
+{
+    FILE *fp;
+    char line[1024];
+    char *p;
+    unsigned cache_jis[FONT_CACHE_NUM] = {0};
+    unsigned long cache_use[FONT_CACHE_NUM] = {0};
+    unsigned long use_clock = 0;
+    unsigned long hit = 0, miss = 0, command = 0;
+    long stream = -1;
+    long offset;
+    unsigned jis;
+    int n, i, slot;
+
+    if((fp = fopen(name, "r")) == NULL)
+    {
+        perror(name);
+        exit(1);
+    }
+    while(fgets(line, sizeof(line), fp) != NULL)
+    {
+        stream = -1;
+        for(p = line, n = 0; n < FONT_LINE_CHARS && sscanf(p, "%x%n", &jis, &i) == 1; p += i, n++)
+        {
+            use_clock++;
+            for(slot = 0; slot < FONT_CACHE_NUM && cache_jis[slot] != jis; slot++)
+            {
+                ;
+            }
+            if(slot < FONT_CACHE_NUM && jis != 0)
+            {
+                cache_use[slot] = use_clock;
+                hit++;
+                continue;
+            }
+
+            slot = 0;
+            for(i = 0; i < FONT_CACHE_NUM; i++)
+            {
+                if(cache_jis[i] == 0)
+                {
+                    slot = i;
+                    break;
+                }
+                if(cache_use[i] < cache_use[slot])
+                {
+                    slot = i;
+                }
+            }
+            cache_jis[slot] = jis;
+            cache_use[slot] = use_clock;
+            miss++;
+
+            /* Read command unless the glyph follows the open stream */
+            if((offset = glyph_offset(jis)) >= 0)
+            {
+                if(offset != stream)
+                {
+                    command++;
+                }
+                stream = offset + FONT_GLYPH_BYTES;
+            }
+        }
+    }
+    fclose(fp);
+
+    printf("hit %lu, miss %lu (%.1f%% hit), read commands %lu, flash bytes %lu\n",
+           hit, miss, (hit + miss) ? 100.0 * hit / (hit + miss) : 0.0,
+           command, command * 4 + miss * FONT_GLYPH_BYTES);
+}
+
+
+/*-----------------------------------------------------
+ * Main
+ *---------------------------------------------------*/
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: font_pack -o image.bin font.bdf\n"
+        "       font_pack -i image.bin -s jis ...\n"
+        "       font_pack -i image.bin -c codes.txt\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *output = NULL;
+    const char *input = NULL;
+    const char *codes = NULL;
+    int show_mode = 0;
+    FILE *fp;
+    int opt;
+    int i;
+
+    while((opt = getopt(argc, argv, "o:i:c:s")) != -1)
+    {
+        switch(opt)
+        {
+            case 'o': output    = optarg; break;
+            case 'i': input     = optarg; break;
+            case 'c': codes     = optarg; break;
+            case 's': show_mode = 1; break;
+            default:  usage();
+        }
+    }
+
+    if(output != NULL)
+    {
+        if(optind != argc - 1)
+        {
+            usage();
+        }
+        image[0] = 'J';
+        image[1] = 'F';
+        image[2] = FONT_GLYPH_BYTES;
+        printf("%d glyphs\n", pack_bdf(argv[optind]));
+        if((fp = fopen(output, "wb")) == NULL || fwrite(image, 1, IMAGE_BYTES, fp) != IMAGE_BYTES)
+        {
+            perror(output);
+            return 1;
+        }
+        fclose(fp);
+        return 0;
+    }
+
+    if(input == NULL)
+    {
+        usage();
+    }
+    load_image(input);
+    if(show_mode)
+    {
+        for(i = optind; i < argc; i++)
+        {
+            show((unsigned)strtoul(argv[i], NULL, 16));
+        }
+    }
+    if(codes != NULL)
+    {
+        cache_run(codes);
+    }
+    return 0;
+}
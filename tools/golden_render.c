@@ -0,0 +1,357 @@
+/*
+ * golden_render : Golden image check of the messages drawn by bitmaps
+ *
+ * Host build of oled_lcd_lib.c and language_ja.c on a model of the WS0010
+ * in graphic mode (100 x 16 dots, 2 lines of 100 columns). Each message of
+ * language_ja[] drawn by bitmap (default, call, not here, responce 1 / 2)
+ * is written as write_message() does it at the end of the wipe
+ * (lcd_write_graphic() at x 0, line 0), then
+ *
+ *   - the display RAM is compared pixel by pixel with tools/golden/<name>.pbm
+ *   - bus bytes and BusyFlag checks of each bus (oled_bus.h) are compared
+ *     with the counts kept in the comment lines of the golden; more than
+ *     the golden is a regression, less is reported so that the golden can
+ *     be updated
+ *
+ * Bus bytes and BusyFlag checks per bus:
+ *
+ *   parallel : 1 byte and 1 check for each command and data byte
+ *   spi      : 10bit frames packed (n frames : (10n + 7) / 8 bytes),
+ *              1 check for each command and data burst
+ *
+ * Messages drawn by text need the font flash and are not checked here.
+ *
+ * Build:
+ *     cc -O2 -Wall -I. -o golden_render tools/golden_render.c oled_lcd_lib.c language_ja.c
+ *
+ * Usage:
+ *     golden_render [-u] [-d golden_dir]
+ *
+ *     -u  write the goldens from the current tree (after a checked change)
+ *     -d  directory of the goldens (default tools/golden)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "oled_lcd_lib.h"
+#include "oled_bus.h"
+#include "language.h"
+
+
+#define LCD_COLUMNS     (100)
+#define LCD_LINES       (2)
+#define LCD_DOTS        (8)     // Dots of 1 column (LSB : top)
+
+enum
+{
+    BUS_PARALLEL,
+    BUS_SPI,
+    BUS_NUM,
+};
+
+typedef struct
+{
+    long bytes;
+    long busy;
+} bus_count_t;
+
+static const char * const bus_name[BUS_NUM] = {"parallel", "spi"};
+
+/* Messages drawn by bitmap */
+static const struct
+{
+    const char *name;
+    uint8_t id;
+} golden[] =
+{
+    {"default",    MESSAGE_DEFAULT},
+    {"call",       MESSAGE_CALL},
+    {"not_here",   MESSAGE_NOT_HERE},
+    {"responce_1", MESSAGE_RESPONCE + RESPONCE1},
+    {"responce_2", MESSAGE_RESPONCE + RESPONCE2},
+};
+#define GOLDEN_NUM  (sizeof(golden) / sizeof(golden[0]))
+
+/* WS0010 model */
+static uint8_t ram[LCD_LINES][LCD_COLUMNS];
+static uint8_t x_address;
+static uint8_t y_address;
+static uint8_t graphic_mode;
+static bus_count_t count[BUS_NUM];
+
+
+/*-----------------------------------------------------
+ * oled_bus.h on the model
+ *---------------------------------------------------*/
+void oled_bus_init(uint8_t power_on)
+{
+    (void)power_on;
+    graphic_mode = 0;
+}
+
+void oled_bus_command(uint8_t command)
+{
+    count[BUS_PARALLEL].bytes++;
+    count[BUS_PARALLEL].busy++;
+    count[BUS_SPI].bytes += 2;
+    count[BUS_SPI].busy++;
+
+    if(command == 0b00000001)
+    {
+        /* Display Clear */
+        memset(ram, 0, sizeof(ram));
+        x_address = 0;
+        y_address = 0;
+    }
+    else if(command == 0b00000010)
+    {
+        /* Return Home */
+        x_address = 0;
+        y_address = 0;
+    }
+    else if(command == 0b00011111)
+    {
+        graphic_mode = 1;
+    }
+    else if(graphic_mode && (command & 0x80))
+    {
+        x_address = command & 0x7F;
+    }
+    else if(graphic_mode && (command & 0xC0) == 0x40)
+    {
+        y_address = command & 0x01;
+    }
+}
+
+void oled_bus_data(const uint8_t *p_data_buf, uint8_t data_len)
+{
+    uint8_t i;
+
+    count[BUS_PARALLEL].bytes += data_len;
+    count[BUS_PARALLEL].busy  += data_len;
+    count[BUS_SPI].bytes      += (data_len * 10 + 7) / 8;
+    count[BUS_SPI].busy++;
+
+    for(i = 0; i < data_len; i++)
+    {
+        if(x_address < LCD_COLUMNS)
+        {
+            ram[y_address][x_address] = p_data_buf[i];
+        }
+        x_address++;
+    }
+}
+
+uint8_t oled_bus_busy(void)
+{
+    return 0;
+}
+
+uint8_t oled_bus_fault(void)
+{
+    return 0;
+}
+
+
+/*-----------------------------------------------------
+ * write_message() of word_graphic.c, end of the wipe
+ *---------------------------------------------------*/
+static void render(uint8_t id)
+{
+    const message_t *p_message = &language_ja[id];
+    write_graphic_param_t message_m;
+
+    message_m.x_axis_address = 0b10000000;
+    message_m.y_axis_address = 0b01000000;
+    message_m.p_message_buf  = (const uint8_t *)p_message->p_data;
+    message_m.message_len    = p_message->len;
+
+    memset(count, 0, sizeof(count));
+    lcd_write_graphic(&message_m);
+}
+
+static int pixel(int x, int y)
+{
+    return (ram[y / LCD_DOTS][x] >> (y % LCD_DOTS)) & 1;
+}
+
+
+/*-----------------------------------------------------
+ * PBM (P1) with counts in comment lines
+ *---------------------------------------------------*/
+static void write_pbm(const char *path)
+{
+    FILE *fp;
+    int x, y, b;
+
+    if((fp = fopen(path, "w")) == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+    fprintf(fp, "P1\n");
+    for(b = 0; b < BUS_NUM; b++)
+    {
+        fprintf(fp, "# %s bytes %ld busy %ld\n", bus_name[b], count[b].bytes, count[b].busy);
+    }
+    fprintf(fp, "%d %d\n", LCD_COLUMNS, LCD_LINES * LCD_DOTS);
+    for(y = 0; y < LCD_LINES * LCD_DOTS; y++)
+    {
+        for(x = 0; x < LCD_COLUMNS; x++)
+        {
+            fputc(pixel(x, y) ? '1' : '0', fp);
+        }
+        fputc('\n', fp);
+    }
+    fclose(fp);
+}
+
+/* Returns number of differing pixels, -1 : no golden */
+static int compare_pbm(const char *path, bus_count_t *p_golden)
+{
+    FILE *fp;
+    char line[256];
+    char name[16];
+    long bytes, busy;
+    int width = 0, height = 0, x = 0, y = 0, c, b, diff = 0;
+
+    if((fp = fopen(path, "r")) == NULL)
+    {
+        return -1;
+    }
+    memset(p_golden, 0, sizeof(bus_count_t) * BUS_NUM);
+
+    /* Header : magic, comments, size */
+    while(fgets(line, sizeof(line), fp) != NULL)
+    {
+        if(line[0] == '#')
+        {
+            if(sscanf(line, "# %15s bytes %ld busy %ld", name, &bytes, &busy) == 3)
+            {
+                for(b = 0; b < BUS_NUM; b++)
+                {
+                    if(strcmp(name, bus_name[b]) == 0)
+                    {
+                        p_golden[b].bytes = bytes;
+                        p_golden[b].busy  = busy;
+                    }
+                }
+            }
+        }
+        else if(sscanf(line, "%d %d", &width, &height) == 2)
+        {
+            break;
+        }
+    }
+    if(width != LCD_COLUMNS || height != LCD_LINES * LCD_DOTS)
+    {
+        fclose(fp);
+        return LCD_COLUMNS * LCD_LINES * LCD_DOTS;
+    }
+
+    while((c = fgetc(fp)) != EOF && y < height)
+    {
+        if(c != '0' && c != '1')
+        {
+            continue;
+        }
+        if((c - '0') != pixel(x, y))
+        {
+            if(diff < 8)
+            {
+                fprintf(stderr, "  pixel x %d y %d : golden %c\n", x, y, c);
+            }
+            diff++;
+        }
+        if(++x == width)
+        {
+            x = 0;
+            y++;
+        }
+    }
+    fclose(fp);
+
+    return (y == height) ? diff : diff + (height - y) * width;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *dir = "tools/golden";
+    char path[512];
+    bus_count_t expect[BUS_NUM];
+    int update = 0;
+    int opt, b, diff, errors = 0;
+    size_t i;
+
+    while((opt = getopt(argc, argv, "ud:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'u': update = 1;      break;
+            case 'd': dir    = optarg; break;
+            default:
+                fprintf(stderr, "usage: golden_render [-u] [-d golden_dir]\n");
+                return 1;
+        }
+    }
+
+    oled_lcd_init(1);
+    goto_graphic_mode();
+
+    printf("message     pixels  parallel bytes/busy     spi bytes/busy\n");
+    for(i = 0; i < GOLDEN_NUM; i++)
+    {
+        render(golden[i].id);
+        snprintf(path, sizeof(path), "%s/%s.pbm", dir, golden[i].name);
+
+        if(update)
+        {
+            write_pbm(path);
+            printf("%-10s  %-6s", golden[i].name, "new");
+            for(b = 0; b < BUS_NUM; b++)
+            {
+                printf(" %8ld/%-4ld     ", count[b].bytes, count[b].busy);
+            }
+            printf("\n");
+            continue;
+        }
+
+        if((diff = compare_pbm(path, expect)) < 0)
+        {
+            printf("%-10s  no golden (%s)\n", golden[i].name, path);
+            errors++;
+            continue;
+        }
+        printf("%-10s  %-6s", golden[i].name, (diff == 0) ? "ok" : "NG");
+        if(diff != 0)
+        {
+            errors++;
+        }
+        for(b = 0; b < BUS_NUM; b++)
+        {
+            printf(" %8ld/%-4ld", count[b].bytes, count[b].busy);
+            if(count[b].bytes > expect[b].bytes || count[b].busy > expect[b].busy)
+            {
+                printf(" NG (golden %ld/%ld)", expect[b].bytes, expect[b].busy);
+                errors++;
+            }
+            else if(count[b].bytes < expect[b].bytes || count[b].busy < expect[b].busy)
+            {
+                printf(" less (golden %ld/%ld, -u)", expect[b].bytes, expect[b].busy);
+            }
+            else
+            {
+                printf("     ");
+            }
+        }
+        printf("\n");
+    }
+
+    if(!update)
+    {
+        printf("%s\n", (errors == 0) ? "ok" : "NG");
+    }
+    return (errors == 0) ? 0 : 2;
+}
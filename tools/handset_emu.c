@@ -0,0 +1,598 @@
+/*
+ * handset_emu : Handset emulator for the door unit link
+ *
+ * Speaks the handset side of protocol.h (point to point, 8bit) on a
+ * pseudo-terminal or on a real serial port (e.g. USB-serial adapter
+ * wired to RC6/RC7 of a door unit):
+ *
+ *   Unit -> Handset  PROTOCOL_CALL    : answer after a configurable delay
+ *   Handset -> Unit  PROTOCOL_RESPONCE1 / PROTOCOL_RESPONCE2
+ *   Unit -> Handset  PROTOCOL_SHOWN   : response is on the door display
+ *   Unit -> Handset  PROTOCOL_CALL_UPDATE, button, presses : repeat presses
+ *   Unit -> Handset  PROTOCOL_PING    : PROTOCOL_PONG at once (heartbeat)
+ *
+ * Round trip time is measured from the call notification to
+ * PROTOCOL_SHOWN, and reported together with the door side part
+ * (response sent -> shown).
+ *
+ * With -b, -m and -z the door receive path is fed with noise; a
+ * PROTOCOL_SHOWN which is not preceded by a response is reported as
+ * a misfire.
+ *
+ * Build:
+ *     cc -O2 -Wall -I. -o handset_emu tools/handset_emu.c -lm
+ *
+ * Usage:
+ *     handset_emu [-D device] [-d min_ms[,max_ms]] [-c 1|2|0] [-n no_answer]
+ *                 [-b burst] [-m malformed] [-z noise] [-h lost] [-k calls] [-j] [-P] [-L] [-s seed]
+ *
+ *     -D  serial device at 9600 8N1 (default: create a pty and print its name)
+ *     -d  response delay range [ms]              (default 2000)
+ *     -c  response code, 0 = random 1 or 2       (default 1)
+ *         64 - 127 : Responce of id 0 - 63 (responce.h)
+ *     -n  probability of not answering           (default 0)
+ *     -b  random bytes injected after each call  (default 0)
+ *     -m  probability of a malformed byte before each response (default 0)
+ *     -z  random non-response bytes per second, sent all the time (default 0)
+ *     -h  probability of not replying to a heartbeat, 1 = out of range (default 0)
+ *     -k  exit after this many calls             (default: run until Ctrl-C)
+ *     -j  read the call journal at start
+ *     -P  read the cycle counters at start (door built with PERF_ENABLE=1)
+ *     -L  read the button -> notification latency histograms at start
+ */
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <math.h>
+#include "protocol.h"
+#include "journal.h"
+
+
+#define SAMPLE_MAX  (4096)
+#define JOURNAL_MAX (JOURNAL_DUMP_HEADER_SIZE + 255 * JOURNAL_RECORD_SIZE)
+
+
+/* Parameters */
+static int    delay_min_ms = 2000;
+static int    delay_max_ms = 2000;
+static int    response     = PROTOCOL_RESPONCE1;
+static double no_answer    = 0.0;
+static int    burst        = 0;
+static double malformed    = 0.0;
+static double noise_rate   = 0.0;
+static double ping_lost    = 0.0;
+static long   call_limit   = 0;
+
+/* State */
+static int    fd;
+static volatile sig_atomic_t stop;
+static double call_time;        // 0 : no call in progress
+static double answer_time;      // Scheduled response
+static double sent_time;        // Response sent
+static int    answer_code;
+static double noise_time;       // Next noise byte
+
+/* Journal reception */
+static uint8_t journal[JOURNAL_MAX];
+static int     journal_len;     // 0 : not receiving
+
+/* Cycle counter reception (JSON line) */
+static int     perf_text;
+
+/* Latency histogram reception */
+static uint8_t latency[3 + 255 + 255 * 255 * 2];
+static int     latency_len;     // 0 : not receiving
+
+/* Call update reception (button, presses) */
+static uint8_t update[2];
+static int     update_len;      // -1 : not receiving
+
+/* Results */
+static double rtt[SAMPLE_MAX];
+static double door_ms[SAMPLE_MAX];
+static int    sample_num;
+static long   cnt_call, cnt_answer, cnt_unknown;
+static long   cnt_noise, cnt_misfire;
+static long   cnt_ping, cnt_pong;
+static long   cnt_update;
+
+
+/*-----------------------------------------------------
+ * Utility
+ *---------------------------------------------------*/
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static double uniform(void)
+{
+    return rand() / ((double)RAND_MAX + 1.0);
+}
+
+static void send_byte(uint8_t data)
+{
+    if(write(fd, &data, 1) != 1)
+    {
+        perror("write");
+        exit(1);
+    }
+}
+
+/* Random byte which is not a valid code for the door */
+static uint8_t malformed_byte(void)
+{
+    uint8_t data;
+
+    do
+    {
+        data = (uint8_t)rand();
+    } while(data == PROTOCOL_RESPONCE1 || data == PROTOCOL_RESPONCE2 ||
+            data == PROTOCOL_JOURNAL_READ || data == PROTOCOL_PERF_READ ||
+            data == PROTOCOL_LATENCY_READ || data == PROTOCOL_BOOT ||
+            data == PROTOCOL_PONG ||
+            (data >= PROTOCOL_LANGUAGE_BASE && data < PROTOCOL_LANGUAGE_BASE + PROTOCOL_LANGUAGE_MAX) ||
+            (data >= PROTOCOL_RESPONCE_BASE && data < PROTOCOL_RESPONCE_BASE + PROTOCOL_RESPONCE_MAX));
+
+    return data;
+}
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop = 1;
+}
+
+
+/*-----------------------------------------------------
+ * Port
+ *---------------------------------------------------*/
+static void set_raw(int port, int set_speed)
+{
+    struct termios tio;
+
+    if(tcgetattr(port, &tio) != 0)
+    {
+        perror("tcgetattr");
+        exit(1);
+    }
+    cfmakeraw(&tio);
+    if(set_speed)
+    {
+        cfsetispeed(&tio, B9600);
+        cfsetospeed(&tio, B9600);
+        tio.c_cflag |= (CLOCAL | CREAD);
+    }
+    tcsetattr(port, TCSANOW, &tio);
+}
+
+static int open_port(const char *device)
+{
+    int master;
+    int slave;
+
+    if(device != NULL)
+    {
+        if((master = open(device, O_RDWR | O_NOCTTY)) < 0)
+        {
+            perror(device);
+            exit(1);
+        }
+        set_raw(master, 1);
+        return master;
+    }
+
+    /* Pseudo-terminal: firmware side opens the printed slave */
+    if((master = posix_openpt(O_RDWR | O_NOCTTY)) < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        perror("posix_openpt");
+        exit(1);
+    }
+    printf("handset on %s\n", ptsname(master));
+    fflush(stdout);
+
+    /* Keep slave open, so that master does not see EIO between clients */
+    if((slave = open(ptsname(master), O_RDWR | O_NOCTTY)) >= 0)
+    {
+        set_raw(slave, 0);
+    }
+    return master;
+}
+
+
+/*-----------------------------------------------------
+ * Journal (journal_dump() of the door)
+ *---------------------------------------------------*/
+static void journal_print(void)
+{
+    static const char *outcome[] = {"responce1", "responce2", "timeout", "other"};
+    int count = journal[1];
+    int boot = journal[2];
+    unsigned now_min = journal[3] | (journal[4] << 8) | ((unsigned)journal[5] << 16);
+    unsigned t;
+    int i;
+
+    printf("journal: %d records, boot %d, door time %umin\n", count, boot, now_min);
+    for(i = 0; i < count; i++)
+    {
+        const uint8_t *r = &journal[JOURNAL_DUMP_HEADER_SIZE + i * JOURNAL_RECORD_SIZE];
+
+        /* Time is comparable with the door time only in the same boot */
+        t = r[2] | (r[3] << 8) | ((unsigned)r[4] << 16);
+        printf("  #%3u  boot %3u  t=%8umin  %-9s  latency %.1fs",
+               r[0], r[1], t, outcome[r[5] >> 6], (r[5] & 0x3F) * 0.5);
+        if(r[1] == boot && t <= now_min)
+        {
+            printf("  (%umin ago)", now_min - t);
+        }
+        printf("\n");
+    }
+}
+
+/* Returns 1 while the byte belongs to a journal transfer */
+static int journal_receive(uint8_t data)
+{
+    if(journal_len == 0)
+    {
+        return 0;
+    }
+
+    journal[journal_len++] = data;
+    if(journal_len >= JOURNAL_DUMP_HEADER_SIZE &&
+       journal_len == JOURNAL_DUMP_HEADER_SIZE + journal[1] * JOURNAL_RECORD_SIZE)
+    {
+        journal_print();
+        journal_len = 0;
+    }
+    return 1;
+}
+
+
+/*-----------------------------------------------------
+ * Latency Histograms (latency_dump() of the door)
+ *---------------------------------------------------*/
+static void latency_print(void)
+{
+    static const char *stage_name[] = {"debounce", "notify", "display"};
+    int stage_num = latency[1];
+    int bin_num   = latency[2];
+    const uint8_t *bound = &latency[3];
+    const uint8_t *count = &latency[3 + bin_num];
+    int stage;
+    int bin;
+
+    printf("latency from button edge [ms]:\n%-10s", "");
+    for(bin = 0; bin < bin_num; bin++)
+    {
+        if(bound[bin] == 0xFF)
+        {
+            printf("    over");
+        }
+        else
+        {
+            printf("  <%5d", bound[bin] * 10);
+        }
+    }
+    printf("\n");
+
+    for(stage = 0; stage < stage_num; stage++)
+    {
+        printf("%-10s", stage < 3 ? stage_name[stage] : "?");
+        for(bin = 0; bin < bin_num; bin++)
+        {
+            const uint8_t *c = &count[(stage * bin_num + bin) * 2];
+
+            printf("  %6u", c[0] | (c[1] << 8));
+        }
+        printf("\n");
+    }
+}
+
+/* Returns 1 while the byte belongs to a histogram transfer */
+static int latency_receive(uint8_t data)
+{
+    if(latency_len == 0)
+    {
+        return 0;
+    }
+
+    latency[latency_len++] = data;
+    if(latency_len >= 3 && latency_len == 3 + latency[2] + latency[1] * latency[2] * 2)
+    {
+        latency_print();
+        latency_len = 0;
+    }
+    return 1;
+}
+
+
+/*-----------------------------------------------------
+ * Protocol
+ *---------------------------------------------------*/
+static void receive(uint8_t data, double t)
+{
+    int i;
+
+    if(journal_receive(data))
+    {
+        return;
+    }
+    if(latency_receive(data))
+    {
+        return;
+    }
+    if(update_len >= 0)
+    {
+        update[update_len++] = data;
+        if(update_len == 2)
+        {
+            cnt_update++;
+            printf("[%10.1f] button %d pressed %d times\n", t, update[0], update[1]);
+            update_len = -1;
+        }
+        return;
+    }
+    if(perf_text)
+    {
+        putchar(data);
+        perf_text = (data != '\n');
+        return;
+    }
+
+    switch(data)
+    {
+        case PROTOCOL_CALL:
+            cnt_call++;
+            call_time   = t;
+            answer_time = 0;
+            sent_time   = 0;
+            printf("[%10.1f] call\n", t);
+
+            for(i = 0; i < burst; i++)
+            {
+                send_byte(malformed_byte());
+            }
+            if(uniform() >= no_answer)
+            {
+                answer_time = t + delay_min_ms + uniform() * (delay_max_ms - delay_min_ms);
+                answer_code = response ? response : (rand() & 1) + PROTOCOL_RESPONCE1;
+            }
+            break;
+
+        case PROTOCOL_CALL_UPDATE:
+            update_len = 0;
+            break;
+
+        case PROTOCOL_SHOWN:
+            if(call_time > 0 && sent_time > 0 && sample_num < SAMPLE_MAX)
+            {
+                rtt[sample_num]     = t - call_time;
+                door_ms[sample_num] = t - sent_time;
+                printf("[%10.1f] shown: rtt %.1fms, door %.1fms\n", t, rtt[sample_num], door_ms[sample_num]);
+                sample_num++;
+            }
+            else if(sent_time == 0)
+            {
+                cnt_misfire++;
+                printf("[%10.1f] misfire: shown without responce\n", t);
+            }
+            call_time = 0;
+            sent_time = 0;
+            if(call_limit && sample_num >= call_limit)
+            {
+                stop = 1;
+            }
+            break;
+
+        case PROTOCOL_JOURNAL_READ:
+            journal[0]  = data;
+            journal_len = 1;
+            break;
+
+        case PROTOCOL_PERF_READ:
+            perf_text = 1;
+            break;
+
+        case PROTOCOL_LATENCY_READ:
+            latency[0]  = data;
+            latency_len = 1;
+            break;
+
+        case PROTOCOL_PING:
+            cnt_ping++;
+            if(uniform() >= ping_lost)
+            {
+                send_byte(PROTOCOL_PONG);
+                cnt_pong++;
+            }
+            break;
+
+        default:
+            cnt_unknown++;
+            printf("[%10.1f] unknown byte 0x%02X\n", t, data);
+            break;
+    }
+}
+
+static void answer(double t)
+{
+    if(uniform() < malformed)
+    {
+        send_byte(malformed_byte());
+    }
+    send_byte((uint8_t)answer_code);
+    cnt_answer++;
+    sent_time   = t;
+    answer_time = 0;
+    printf("[%10.1f] responce %d\n", t, answer_code);
+}
+
+
+/*-----------------------------------------------------
+ * Main
+ *---------------------------------------------------*/
+static int compare(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, double *v, int n)
+{
+    if(n == 0)
+    {
+        return;
+    }
+    qsort(v, n, sizeof(double), compare);
+    printf("%-18s p50 %8.1f  p90 %8.1f  max %8.1f [ms]\n",
+           name, v[n / 2], v[(n * 9) / 10], v[n - 1]);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "usage: handset_emu [-D device] [-d min_ms[,max_ms]] [-c 1|2|0] [-n no_answer]\n"
+        "                   [-b burst] [-m malformed] [-z noise] [-h lost] [-k calls] [-j] [-P] [-L] [-s seed]\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *device = NULL;
+    int read_journal = 0;
+    int read_perf = 0;
+    int read_latency = 0;
+    struct pollfd pfd;
+    uint8_t buf[64];
+    double t;
+    double next;
+    int timeout;
+    int opt;
+    int n;
+    int i;
+
+    srand((unsigned)time(NULL));
+    while((opt = getopt(argc, argv, "D:d:c:n:b:m:z:h:k:jPLs:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'D': device = optarg; break;
+            case 'd':
+                if(sscanf(optarg, "%d,%d", &delay_min_ms, &delay_max_ms) < 2)
+                {
+                    delay_max_ms = delay_min_ms;
+                }
+                break;
+            case 'c': response     = atoi(optarg); break;
+            case 'n': no_answer    = atof(optarg); break;
+            case 'b': burst        = atoi(optarg); break;
+            case 'm': malformed    = atof(optarg); break;
+            case 'z': noise_rate   = atof(optarg); break;
+            case 'h': ping_lost    = atof(optarg); break;
+            case 'k': call_limit   = atol(optarg); break;
+            case 'j': read_journal = 1; break;
+            case 'P': read_perf    = 1; break;
+            case 'L': read_latency = 1; break;
+            case 's': srand((unsigned)atoi(optarg)); break;
+            default:  usage();
+        }
+    }
+    if(response < 0 || (response > PROTOCOL_RESPONCE2 && response < PROTOCOL_RESPONCE_BASE) ||
+       response >= PROTOCOL_RESPONCE_BASE + PROTOCOL_RESPONCE_MAX || delay_max_ms < delay_min_ms)
+    {
+        usage();
+    }
+
+    update_len = -1;
+    fd = open_port(device);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    if(read_journal)
+    {
+        send_byte(PROTOCOL_JOURNAL_READ);
+    }
+    if(read_perf)
+    {
+        send_byte(PROTOCOL_PERF_READ);
+    }
+    if(read_latency)
+    {
+        send_byte(PROTOCOL_LATENCY_READ);
+    }
+
+    if(noise_rate > 0)
+    {
+        noise_time = now_ms();
+    }
+
+    pfd.fd     = fd;
+    pfd.events = POLLIN;
+    while(!stop)
+    {
+        /* Sleep until next byte, noise or scheduled response */
+        next = (answer_time > 0) ? answer_time : 0;
+        if(noise_time > 0 && (next == 0 || noise_time < next))
+        {
+            next = noise_time;
+        }
+        timeout = -1;
+        if(next > 0)
+        {
+            timeout = (int)(next - now_ms());
+            if(timeout < 0)
+            {
+                timeout = 0;
+            }
+        }
+
+        if(poll(&pfd, 1, timeout) < 0)
+        {
+            break;
+        }
+        t = now_ms();
+
+        if(pfd.revents & POLLIN)
+        {
+            n = read(fd, buf, sizeof(buf));
+            for(i = 0; i < n; i++)
+            {
+                receive(buf[i], t);
+            }
+        }
+        if(answer_time > 0 && t >= answer_time)
+        {
+            answer(t);
+        }
+        if(noise_time > 0 && t >= noise_time)
+        {
+            /* Poisson arrivals */
+            send_byte(malformed_byte());
+            cnt_noise++;
+            noise_time = t - log(1.0 - uniform()) * 1000.0 / noise_rate;
+        }
+    }
+
+    printf("calls %ld, answered %ld, unknown bytes %ld, noise bytes %ld, misfires %ld\n",
+           cnt_call, cnt_answer, cnt_unknown, cnt_noise, cnt_misfire);
+    printf("heartbeats %ld, replied %ld, call updates %ld\n", cnt_ping, cnt_pong, cnt_update);
+    report("call -> shown", rtt, sample_num);
+    report("responce -> shown", door_ms, sample_num);
+
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * pool_model : Host build of pool.c (RAM budget and allocator check)
+ *
+ * Prints the RAM budget of the block classes of pool.h, then runs pool.c
+ * with random allocations and frees (including double frees and foreign
+ * pointers) and checks that
+ *
+ *   - a block is never given twice, and blocks do not overlap
+ *     (each owner fills its block with its own pattern)
+ *   - NULL is returned only when the class has no free block
+ *   - used / peak / fail of pool_get_stats() match the model
+ *
+ * Build:
+ *     cc -O2 -Wall -I. -o pool_model tools/pool_model.c pool.c
+ *
+ * Usage:
+ *     pool_model [-n operations] [-s seed]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "pool.h"
+
+
+#define RAM_BYTES   (1024)      // PIC16F1938
+
+
+static const char * const class_name[POOL_CLASS_NUM] = {"small", "frame", "line"};
+
+/* Model of each class */
+static uint8_t *owner_block[POOL_CLASS_NUM][256];
+static uint8_t  owner_mark[POOL_CLASS_NUM][256];
+static int      used[POOL_CLASS_NUM];
+static int      peak[POOL_CLASS_NUM];
+static int      fail[POOL_CLASS_NUM];
+static int      errors;
+
+
+static void check(int ok, const char *what, int c)
+{
+    if(!ok)
+    {
+        if(errors < 10)
+        {
+            fprintf(stderr, "error: %s (class %s)\n", what, class_name[c]);
+        }
+        errors++;
+    }
+}
+
+static void verify_blocks(void)
+{
+    int c, i, b;
+
+    for(c = 0; c < POOL_CLASS_NUM; c++)
+    {
+        for(i = 0; i < used[c]; i++)
+        {
+            for(b = 0; b < pool_get_size(c); b++)
+            {
+                if(owner_block[c][i][b] != owner_mark[c][i])
+                {
+                    check(0, "block overwritten by another owner", c);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    long ops = 100000;
+    unsigned seed = 1;
+    long n;
+    int opt, c, i, total;
+    uint8_t *p;
+    uint8_t mark = 0;
+    uint8_t foreign[8];
+    const pool_stats_t *p_stats;
+
+    while((opt = getopt(argc, argv, "n:s:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'n': ops  = atol(optarg); break;
+            case 's': seed = (unsigned)atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: pool_model [-n operations] [-s seed]\n");
+                return 1;
+        }
+    }
+    srand(seed);
+
+    /* Budget */
+    printf("class  size  num  bytes\n");
+    for(c = 0, total = 0; c < POOL_CLASS_NUM; c++)
+    {
+        printf("%-5s  %4d  %3d  %5d\n", class_name[c], pool_get_size(c), pool_get_num(c),
+               pool_get_size(c) * pool_get_num(c));
+        total += pool_get_size(c) * pool_get_num(c);
+    }
+    printf("total %d bytes (%.1f%% of %d byte RAM), free list %d bytes\n",
+           total, 100.0 * total / RAM_BYTES, RAM_BYTES, POOL_BLOCK_NUM + POOL_CLASS_NUM);
+    check(total == POOL_AREA_SIZE, "POOL_AREA_SIZE", 0);
+
+    /* Random use */
+    pool_init();
+    for(n = 0; n < ops; n++)
+    {
+        c = rand() % POOL_CLASS_NUM;
+
+        if((rand() % 2) == 0)
+        {
+            p = pool_alloc(c);
+            if(used[c] == pool_get_num(c))
+            {
+                check(p == NULL, "block beyond the class", c);
+                fail[c]++;
+                continue;
+            }
+            check(p != NULL, "NULL with a free block", c);
+            if(p == NULL)
+            {
+                continue;
+            }
+            owner_block[c][used[c]] = p;
+            owner_mark[c][used[c]]  = ++mark;
+            memset(p, mark, pool_get_size(c));
+            if(++used[c] > peak[c])
+            {
+                peak[c] = used[c];
+            }
+        }
+        else if(used[c] != 0)
+        {
+            i = rand() % used[c];
+            p = owner_block[c][i];
+            pool_free(p);
+            owner_block[c][i] = owner_block[c][used[c] - 1];
+            owner_mark[c][i]  = owner_mark[c][used[c] - 1];
+            used[c]--;
+
+            /* Double free, middle of a block, foreign pointer : ignored */
+            switch(rand() % 8)
+            {
+                case 0: pool_free(p);     break;
+                case 1: pool_free(p + 1); break;
+                case 2: pool_free(foreign); break;
+                default: break;
+            }
+        }
+        verify_blocks();
+    }
+
+    /* Statistics */
+    printf("after %ld operations:\n", ops);
+    printf("class  used  peak  fail\n");
+    for(c = 0; c < POOL_CLASS_NUM; c++)
+    {
+        p_stats = pool_get_stats(c);
+        printf("%-5s  %4d  %4d  %4d\n", class_name[c], p_stats->used, p_stats->peak, p_stats->fail);
+        check(p_stats->used == used[c], "used", c);
+        check(p_stats->peak == peak[c], "peak", c);
+        check(p_stats->fail == ((fail[c] > 0xFF) ? 0xFF : fail[c]), "fail", c);
+    }
+
+    printf("%s (%d errors)\n", (errors == 0) ? "ok" : "NG", errors);
+    return (errors == 0) ? 0 : 2;
+}
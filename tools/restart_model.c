@@ -0,0 +1,204 @@
+/*
+ * restart_model : Recovery time of the door unit after a fault
+ *
+ * Models how long the door unit is out of service for each kind of fault
+ * handled by supervisor.c, from the fault until the screen (and the call
+ * state) before the fault is back on the display:
+ *
+ *   display  : LCD stops releasing BusyFlag. check_busy_flag() gives up
+ *              after OLED_BUSY_TIMEOUT_MS, main loop calls
+ *              supervisor_restart() (RESET instruction)
+ *   hang     : a loop which does not return to the main loop. Watchdog
+ *              resets the unit after SUPERVISOR_WDT_MS (LFINTOSC range)
+ *   stack    : hardware stack overflow / underflow (STVREN = ON)
+ *
+ * and compares the warm restart (no power stabilization wait, no splash
+ * wait, saved screen and timers) with a cold start. It also checks that
+ * the longest path between kicks of the Watchdog is shorter than the
+ * shortest Watchdog period.
+ *
+ * Timing constants are taken from the firmware headers (xc.h is left out
+ * of the host build).
+ *
+ * Build:
+ *     cc -O2 -Wall -I. -o restart_model tools/restart_model.c
+ *
+ * Usage:
+ *     restart_model [-u bus_byte_us] [-w wdt_ms] [-o busy_timeout_ms]
+ *                   [-l loop_ms | -p perf.json] [-m budget_ms]
+ *
+ *     bus_byte_us : time of 1 display byte at CLOCK_MODE_FAST
+ *                   (default 40, OLED_BUS_SPI 10bit frame at Fosc/64)
+ *     wdt_ms      : nominal Watchdog period, 0.63 - 1.69 times of it
+ *                   (datasheet TWDT 10 - 27ms for 16ms)
+ *     loop_ms     : longest pass of the main loop (default 50)
+ *     perf.json   : reply of PROTOCOL_PERF_READ (PERF_ENABLE=1 build), the
+ *                   longest time between kicks is the max of probe
+ *                   "wdt_kick". Timer1 counts Fosc/4 of the clock mode in
+ *                   use, so the cycles are taken at CLOCK_FREQ_IDLE (the
+ *                   slowest) as an upper bound
+ *     budget_ms   : recovery time to meet (default 1000)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "supervisor.h"
+#include "oled_bus.h"
+#include "systick.h"
+#include "transition.h"
+#include "protocol.h"
+#include "pic_clock.h"
+
+
+/* main.c / oled_bus_*.c (cold start only) */
+#define POWER_WAIT_MS           (500 + 500)     // main() + oled_bus_init()
+#define SPLASH_WAIT_MS          (1000)
+#define PWRT_MS                 (64)            // PWRTE = ON, power on only
+
+/* Watchdog period range (LFINTOSC) */
+#define WDT_MIN_RATIO           (10.0 / 16.0)
+#define WDT_MAX_RATIO           (27.0 / 16.0)
+
+/* WS0010 */
+#define LCD_COMMAND_US          (50)
+#define LCD_CLEAR_US            (6200)          // Display Clear, Return Home
+
+/* Reset and startup code (oscillator start, RAM clear) */
+#define STARTUP_MS              (2)
+
+
+typedef struct
+{
+    const char *name;
+    double detect_ms;
+} fault_t;
+
+
+/*-----------------------------------------------------
+ * Max of probe "wdt_kick" in perf JSON, in ms at CLOCK_FREQ_IDLE
+ *---------------------------------------------------*/
+static double perf_kick_ms(const char *name)
+{
+    static char text[4096];
+    FILE *fp;
+    size_t len;
+    char *p;
+
+    if((fp = fopen(name, "r")) == NULL)
+    {
+        perror(name);
+        exit(1);
+    }
+    len = fread(text, 1, sizeof(text) - 1, fp);
+    text[len] = '\0';
+    fclose(fp);
+
+    if((p = strstr(text, "\"name\":\"wdt_kick\"")) == NULL || (p = strstr(p, "\"max\":")) == NULL)
+    {
+        fprintf(stderr, "%s: no wdt_kick probe (PERF_ENABLE=1 build)\n", name);
+        exit(1);
+    }
+
+    return strtod(p + 6, NULL) * 4 * 1000.0 / CLOCK_FREQ_IDLE;
+}
+
+
+/*-----------------------------------------------------
+ * oled_lcd_init() + goto_graphic_mode() without waits
+ *---------------------------------------------------*/
+static double display_init_ms(void)
+{
+    /* Function Set, Display ON, Entry Mode, Graphic Mode : short */
+    /* Display Clear, Return Home, Display Clear          : long  */
+    return (4 * LCD_COMMAND_US + 3 * LCD_CLEAR_US) / 1000.0;
+}
+
+
+/*-----------------------------------------------------
+ * show_screen() : wipe of 100 x 2 columns
+ *---------------------------------------------------*/
+static double redraw_ms(double byte_us)
+{
+    int steps = (TRANSITION_BLOCK_NUM + TRANSITION_STEP_BLOCKS - 1) / TRANSITION_STEP_BLOCKS;
+    /* 200 columns and 2 address commands per block and line */
+    double bus_ms = (200 + TRANSITION_BLOCK_NUM * 2 * 2) * byte_us / 1000.0;
+    double step_ms = (double)(steps - 1) * TRANSITION_STEP_MS;
+
+    /* Steps are paced by the timer wheel, the bus time of each step overlaps */
+    return (step_ms > bus_ms) ? step_ms + bus_ms / steps : bus_ms;
+}
+
+
+int main(int argc, char *argv[])
+{
+    double byte_us   = 40;
+    double wdt_ms    = SUPERVISOR_WDT_MS;
+    double busy_ms   = OLED_BUSY_TIMEOUT_MS;
+    double loop_ms   = 50;
+    double budget_ms = 1000;
+    double warm_ms, cold_ms, total_ms, worst_ms = 0;
+    double notify_ms, kick_ms, wdt_min_ms;
+    int opt, i, errors = 0;
+    fault_t fault[3];
+
+    while((opt = getopt(argc, argv, "u:w:o:l:p:m:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'u': byte_us   = atof(optarg); break;
+            case 'w': wdt_ms    = atof(optarg); break;
+            case 'o': busy_ms   = atof(optarg); break;
+            case 'l': loop_ms   = atof(optarg); break;
+            case 'p': loop_ms   = perf_kick_ms(optarg); break;
+            case 'm': budget_ms = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: restart_model [-u bus_byte_us] [-w wdt_ms] [-o busy_timeout_ms]\n"
+                                "                     [-l loop_ms | -p perf.json] [-m budget_ms]\n");
+                return 1;
+        }
+    }
+
+    /* Fault to reset : the rest of a faulted redraw does not wait for BusyFlag */
+    fault[0].name      = "display";
+    fault[0].detect_ms = busy_ms + SYSTICK_PERIOD_MS + redraw_ms(byte_us);
+    fault[1].name      = "hang";
+    fault[1].detect_ms = wdt_ms * WDT_MAX_RATIO;
+    fault[2].name      = "stack";
+    fault[2].detect_ms = 0;
+
+    warm_ms = STARTUP_MS + display_init_ms() + redraw_ms(byte_us);
+    cold_ms = PWRT_MS + STARTUP_MS + POWER_WAIT_MS + display_init_ms() + SPLASH_WAIT_MS + redraw_ms(byte_us);
+
+    printf("restart  warm %7.1f ms, cold %7.1f ms (display init %.1f ms, redraw %.1f ms)\n",
+           warm_ms, cold_ms, display_init_ms(), redraw_ms(byte_us));
+    printf("fault    detect    warm total  cold total\n");
+    for(i = 0; i < 3; i++)
+    {
+        total_ms = fault[i].detect_ms + warm_ms;
+        printf("%-7s  %7.1f  %10.1f  %10.1f  %s\n", fault[i].name, fault[i].detect_ms,
+               total_ms, fault[i].detect_ms + cold_ms, (total_ms < budget_ms) ? "ok" : "NG");
+        if(total_ms >= budget_ms)
+        {
+            errors++;
+        }
+        if(total_ms > worst_ms)
+        {
+            worst_ms = total_ms;
+        }
+    }
+
+    /* Longest path between kicks */
+    notify_ms  = (PROTOCOL_ACK_TIMEOUT_MS > PROTOCOL_BACKOFF_SLOT_MS) ? PROTOCOL_ACK_TIMEOUT_MS : PROTOCOL_BACKOFF_SLOT_MS;
+    kick_ms    = (notify_ms > loop_ms) ? notify_ms : loop_ms;
+    wdt_min_ms = wdt_ms * WDT_MIN_RATIO;
+    printf("kick     main loop %.0f ms, notify %.0f ms, watchdog %.0f ms at least : %s\n",
+           loop_ms, notify_ms, wdt_min_ms, (kick_ms < wdt_min_ms) ? "ok" : "NG");
+    if(kick_ms >= wdt_min_ms)
+    {
+        errors++;
+    }
+
+    printf("worst recovery %.1f ms (budget %.0f ms) : %s\n", worst_ms, budget_ms, (errors == 0) ? "ok" : "NG");
+    return (errors == 0) ? 0 : 2;
+}
@@ -0,0 +1,383 @@
+/*
+ * usart_fuzz : Fuzzing and throughput harness of the USART receive path
+ *
+ * Host build of the receive path of usart.c (usart_rx_isr(), usart_receive(),
+ * usart_rx_flush(), usart_get_rx_stats()) and of responce_find(), driven
+ * through simulated RCSTA / RCREG / RCIE. An input is a list of events of
+ * 2 bytes:
+ *
+ *   byte 0 : bit 0 FERR, bit 1 OERR, bit 2 RX9D (9th bit, multi-drop),
+ *            bit 4 - 7 polls of usart_receive() by the main loop after it
+ *   byte 1 : RCREG
+ *
+ * Each event raises RCIF (unless Address Detect ignores it) and calls
+ * usart_rx_isr(). A model of the EUSART and of the receive buffer checks
+ * after every event that
+ *
+ *   - usart_receive() gives exactly the bytes received without error, in
+ *     order, and nothing when the model is empty (no misfired Responce:
+ *     Responces decoded by responce_find() match the model)
+ *   - bytes beyond USART_RX_BUF_SIZE are dropped and counted, overrun and
+ *     framing errors are counted (usart_get_rx_stats())
+ *   - RCIE is restored by usart_receive(), CREN is left set, and in
+ *     multi-drop ADDEN follows the address bytes (own address is 0 in the
+ *     host build, PROTOCOL_BROADCAST_ADDRESS is also accepted)
+ *
+ * Any mismatch aborts. Every call returns without waiting, so a hang is a
+ * libFuzzer timeout.
+ *
+ * The benchmark (-b) feeds 1 byte per byte time of the line (1 virtual
+ * cycle) with line noise and reports received bytes per virtual cycle at
+ * the given polls per byte time, and host time of usart_rx_isr() and
+ * usart_receive() per call, so that a change of the receive path cannot
+ * quietly slow down the interrupt.
+ *
+ * Build:
+ *     cc -O2 -Wall -I. -o usart_fuzz tools/usart_fuzz.c usart.c responce.c
+ *     clang -g -O1 -fsanitize=fuzzer,address -DUSART_FUZZER -I. \
+ *         -o usart_fuzzer tools/usart_fuzz.c usart.c responce.c
+ *     (add -DUSART_MULTIDROP=1 for the multi-drop receive path)
+ *
+ * Usage:
+ *     usart_fuzz [-n inputs] [-s seed] [-b] [-p polls] [-z noise] [file ...]
+ *     usart_fuzzer [libFuzzer options] [corpus]
+ *
+ *     -n  random inputs (default 100000), files are replayed instead
+ *     -b  benchmark instead of random inputs
+ *     -p  polls of usart_receive() per byte time (default 1)
+ *     -z  probability of a framing error / overrun per byte (default 0.05)
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "usart.h"
+#include "responce.h"
+
+
+#define EVENT_FERR      (1 << 0)
+#define EVENT_OERR      (1 << 1)
+#define EVENT_RX9D      (1 << 2)
+#define EVENT_POLLS(b)  ((b) >> 4)
+
+
+/* Registers (usart.h, host build) */
+volatile uint8_t RCSTA;
+volatile uint8_t RCREG;
+volatile usart_host_pie1_t PIE1bits;
+
+
+/* Model of EUSART and receive buffer */
+static uint8_t model_buf[USART_RX_BUF_SIZE];
+static int model_head, model_count;
+static uint8_t model_adden;
+static usart_rx_stats_t model_stats;
+
+
+static void check(int ok, const char *what)
+{
+    if(!ok)
+    {
+        fprintf(stderr, "error: %s\n", what);
+        abort();
+    }
+}
+
+
+/*-----------------------------------------------------
+ * Start of an input : empty buffer, receiver enabled
+ *---------------------------------------------------*/
+static void reset(void)
+{
+    usart_rx_flush();
+    RCSTA = RCSTA_SPEN | RCSTA_CREN;
+#if USART_MULTIDROP
+    RCSTA |= RCSTA_RX9 | RCSTA_ADDEN;
+#endif
+    model_head  = 0;
+    model_count = 0;
+    model_adden = USART_MULTIDROP;
+    model_stats = *usart_get_rx_stats();
+}
+
+
+/*-----------------------------------------------------
+ * 1 byte on the line
+ *---------------------------------------------------*/
+static void receive_byte(uint8_t status, uint8_t data)
+{
+    uint8_t rx9d = (USART_MULTIDROP && (status & EVENT_RX9D)) ? 1 : 0;
+
+    /* Address Detect : Data bytes do not set RCIF */
+    if(model_adden && !rx9d)
+    {
+        return;
+    }
+
+    RCSTA = (uint8_t)(RCSTA & ~(RCSTA_OERR | RCSTA_FERR | RCSTA_RX9D));
+    RCSTA |= (status & EVENT_OERR) ? RCSTA_OERR : 0;
+    RCSTA |= (status & EVENT_FERR) ? RCSTA_FERR : 0;
+    RCSTA |= rx9d ? RCSTA_RX9D : 0;
+    RCREG = data;
+
+    usart_rx_isr();
+
+    /* Model */
+    if(status & EVENT_OERR)
+    {
+        model_stats.overrun++;
+        model_adden = USART_MULTIDROP;
+    }
+    else if(status & EVENT_FERR)
+    {
+        model_stats.framing++;
+        model_adden = USART_MULTIDROP;
+    }
+    else if(rx9d)
+    {
+        model_adden = !((data == 0) || (data == PROTOCOL_BROADCAST_ADDRESS));
+    }
+    else
+    {
+        model_adden = USART_MULTIDROP;
+        if(model_count < USART_RX_BUF_SIZE)
+        {
+            model_buf[(model_head + model_count) % USART_RX_BUF_SIZE] = data;
+            model_count++;
+        }
+        else
+        {
+            model_stats.dropped++;
+        }
+    }
+
+    check((RCSTA & RCSTA_CREN) != 0, "receiver left stopped (CREN)");
+#if USART_MULTIDROP
+    check(((RCSTA & RCSTA_ADDEN) != 0) == model_adden, "ADDEN");
+#endif
+    check(memcmp((const void *)usart_get_rx_stats(), &model_stats, sizeof(model_stats)) == 0, "error counters");
+}
+
+
+/*-----------------------------------------------------
+ * 1 poll of the main loop
+ *---------------------------------------------------*/
+static void main_poll(void)
+{
+    uint8_t data;
+    uint8_t got;
+
+    PIE1bits.RCIE = 1;
+    got = usart_receive(&data);
+    check(PIE1bits.RCIE == 1, "RCIE not restored");
+
+    if(model_count == 0)
+    {
+        check(got == 0, "byte out of an empty buffer");
+        return;
+    }
+    check(got == 1, "byte lost");
+    check(data == model_buf[model_head], "wrong byte");
+    check(responce_find(data) == responce_find(model_buf[model_head]), "misfired Responce");
+    model_head = (model_head + 1) % USART_RX_BUF_SIZE;
+    model_count--;
+}
+
+
+/*-----------------------------------------------------
+ * libFuzzer entry
+ *---------------------------------------------------*/
+int LLVMFuzzerTestOneInput(const uint8_t *p_data, size_t size)
+{
+    size_t i;
+    int n;
+
+    reset();
+    for(i = 0; i + 1 < size; i += 2)
+    {
+        receive_byte(p_data[i], p_data[i + 1]);
+        for(n = 0; n < EVENT_POLLS(p_data[i]); n++)
+        {
+            main_poll();
+        }
+    }
+
+    /* Main loop takes everything left */
+    for(n = 0; n <= USART_RX_BUF_SIZE; n++)
+    {
+        main_poll();
+    }
+
+    return 0;
+}
+
+
+#if !defined(USART_FUZZER)
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void replay(const char *name)
+{
+    static uint8_t input[65536];
+    FILE *fp;
+    size_t size;
+
+    if((fp = fopen(name, "rb")) == NULL)
+    {
+        perror(name);
+        exit(1);
+    }
+    size = fread(input, 1, sizeof(input), fp);
+    fclose(fp);
+    LLVMFuzzerTestOneInput(input, size);
+    printf("%s: ok\n", name);
+}
+
+static void benchmark(int polls, double noise)
+{
+    static uint8_t line_status[4096], line_data[4096];
+    const long cycles = 2000000;
+    long c, received = 0;
+    double t, isr_ns, receive_ns;
+    uint8_t status, data;
+    int n;
+
+    reset();
+    for(c = 0; c < cycles; c++)
+    {
+        status = 0;
+        if(drand48() < noise)
+        {
+            status = (drand48() < 0.5) ? EVENT_FERR : EVENT_OERR;
+        }
+#if USART_MULTIDROP
+        /* Address (own) and Data byte */
+        if((c & 1) == 0)
+        {
+            status |= EVENT_RX9D;
+        }
+        data = (c & 1) ? (uint8_t)lrand48() : 0;
+#else
+        data = (uint8_t)lrand48();
+#endif
+        line_status[c % 4096] = status;
+        line_data[c % 4096]   = data;
+
+        receive_byte(status, data);
+        for(n = 0; n < polls; n++)
+        {
+            if(model_count != 0)
+            {
+                received++;
+            }
+            main_poll();
+        }
+    }
+
+    /* Time of the receive path alone (same line, no model) */
+    reset();
+    t = now_ns();
+    for(c = 0; c < cycles; c++)
+    {
+        RCSTA = (uint8_t)((RCSTA & ~(RCSTA_OERR | RCSTA_FERR | RCSTA_RX9D)) |
+                          ((line_status[c % 4096] & EVENT_OERR) ? RCSTA_OERR : 0) |
+                          ((line_status[c % 4096] & EVENT_FERR) ? RCSTA_FERR : 0) |
+                          ((line_status[c % 4096] & EVENT_RX9D) ? RCSTA_RX9D : 0));
+        RCREG = line_data[c % 4096];
+        usart_rx_isr();
+    }
+    isr_ns = now_ns() - t;
+
+    t = now_ns();
+    for(c = 0; c < cycles; c++)
+    {
+        if((c & 7) == 0)
+        {
+            RCSTA = (uint8_t)(RCSTA & ~(RCSTA_OERR | RCSTA_FERR | RCSTA_RX9D | RCSTA_ADDEN));
+            for(n = 0; n < USART_RX_BUF_SIZE; n++)
+            {
+                RCREG = (uint8_t)n;
+                usart_rx_isr();
+            }
+        }
+        usart_receive(&data);
+    }
+    receive_ns = now_ns() - t;
+
+    printf("virtual cycles %ld (1 byte time each), polls %d, noise %.3f\n", cycles, polls, noise);
+    printf("received       %.4f bytes / virtual cycle\n", (double)received / cycles);
+    printf("dropped        %u (buffer full, counter wraps at 255)\n", model_stats.dropped);
+    printf("usart_rx_isr   %.1f ns / call (host)\n", isr_ns / cycles);
+    printf("usart_receive  %.1f ns / call (host, with refill)\n", receive_ns / cycles);
+}
+
+
+int main(int argc, char *argv[])
+{
+    static uint8_t input[512];
+    long inputs = 100000;
+    long i;
+    size_t size, j;
+    int polls = 1;
+    double noise = 0.05;
+    int bench = 0;
+    int opt;
+
+    srand48(1);
+    while((opt = getopt(argc, argv, "n:s:bp:z:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'n': inputs = atol(optarg);         break;
+            case 's': srand48(atol(optarg));         break;
+            case 'b': bench  = 1;                    break;
+            case 'p': polls  = atoi(optarg);         break;
+            case 'z': noise  = atof(optarg);         break;
+            default:
+                fprintf(stderr, "usage: usart_fuzz [-n inputs] [-s seed] [-b] [-p polls] [-z noise] [file ...]\n");
+                return 1;
+        }
+    }
+
+    if(bench)
+    {
+        benchmark(polls, noise);
+        return 0;
+    }
+    if(optind < argc)
+    {
+        for(; optind < argc; optind++)
+        {
+            replay(argv[optind]);
+        }
+        return 0;
+    }
+
+    for(i = 0; i < inputs; i++)
+    {
+        size = (size_t)(lrand48() % sizeof(input));
+        for(j = 0; j < size; j++)
+        {
+            input[j] = (uint8_t)lrand48();
+
+            /* Mostly no poll, so that the buffer fills up */
+            if(((j & 1) == 0) && (lrand48() % 4 != 0))
+            {
+                input[j] &= 0x0F;
+            }
+        }
+        LLVMFuzzerTestOneInput(input, size);
+    }
+    printf("%ld random inputs : ok (multi-drop %d)\n", inputs, USART_MULTIDROP);
+
+    return 0;
+}
+#endif
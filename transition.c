@@ -0,0 +1,197 @@
+#include <xc.h>
+#include "transition.h"
+#include "oled_lcd_lib.h"
+#include "marquee.h"
+#include "pic_clock.h"
+#include "timer_wheel.h"
+#include "perf.h"
+
+
+/* Prototype of Static Function */
+static uint8_t column(uint8_t line, uint8_t x);
+static void step(void);
+
+
+/* Block Order */
+static const uint8_t wipe_left_order[TRANSITION_BLOCK_NUM] =
+{
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+    13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24
+};
+
+static const uint8_t wipe_center_order[TRANSITION_BLOCK_NUM] =
+{
+    12, 11, 13, 10, 14, 9, 15, 8, 16, 7, 17, 6, 18,
+    5, 19, 4, 20, 3, 21, 2, 22, 1, 23, 0, 24
+};
+
+
+/* Transition */
+static write_graphic_param_t target;    // New screen
+static const uint8_t *p_order;
+static uint8_t next_block;              // Index of p_order
+static uint8_t active;
+
+
+/*=====================================================
+ * @brief
+ *     Write Graphic to LCD with Transition
+ * @param
+ *     p_param:pointer to write graphic parameter
+ *     effect :transition effect
+ * @return
+ *     none:
+ * @note
+ *     First step is written before return.
+ *     Message wider than the display is shown by
+ *     marquee_show() (TRANSITION_CUT).
+ *     p_message_buf must stay valid (const in flash)
+ *===================================================*/
+void transition_show(const write_graphic_param_t *p_param, transition_t effect)
+{
+    /* Previous transition and marquee are replaced */
+    timer_stop(TIMER_TRANSITION);
+    active = 0;
+    marquee_stop();
+
+    if((effect == TRANSITION_CUT) ||
+       ((uint16_t)(p_param->x_axis_address & 0x7F) + p_param->message_len > MARQUEE_WIDTH))
+    {
+        marquee_show(p_param);
+        return;
+    }
+
+    target     = *p_param;
+    p_order    = (effect == TRANSITION_WIPE_LEFT) ? wipe_left_order : wipe_center_order;
+    next_block = 0;
+    active     = 1;
+
+    step();
+    timer_start(TIMER_TRANSITION, TIMER_TICKS(TRANSITION_STEP_MS));
+}
+
+
+/*=====================================================
+ * @brief
+ *     Transition Task (called from main loop)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Writes TRANSITION_STEP_BLOCKS blocks at each
+ *     TIMER_TRANSITION expiration
+ *===================================================*/
+void transition_task(void)
+{
+    if((active == 0) || (timer_expired(TIMER_TRANSITION) == 0))
+    {
+        return;
+    }
+
+    clock_set_mode(CLOCK_MODE_FAST);
+    PERF_BEGIN(PERF_TRANSITION_STEP);
+    step();
+    PERF_END(PERF_TRANSITION_STEP);
+    clock_set_mode(CLOCK_MODE_IDLE);
+
+    if(active)
+    {
+        timer_start(TIMER_TRANSITION, TIMER_TICKS(TRANSITION_STEP_MS));
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Check Transition in Progress
+ * @param
+ *     none:
+ * @return
+ *     1:Writing new screen, 0:Done
+ * @note
+ *     Animations wait for the end, so that the wipe
+ *     does not overwrite them
+ *===================================================*/
+uint8_t transition_busy(void)
+{
+    return active;
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Column Data of the New Screen
+ * @param
+ *     line:y address (0 - 1)
+ *     x   :x address (0 - 99)
+ * @return
+ *     graphic data (blank out of the message)
+ * @note
+ *     none
+ *---------------------------------------------------*/
+static uint8_t column(uint8_t line, uint8_t x)
+{
+    uint8_t x_start = (uint8_t)(target.x_axis_address & 0x7F);
+
+    if((line != (target.y_axis_address & 0x01)) ||
+       (x < x_start) || ((uint8_t)(x - x_start) >= target.message_len))
+    {
+        return 0x00;
+    }
+    return target.p_message_buf[x - x_start];
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Write Next Blocks (both lines)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     x address is not set again when the block
+ *     follows the previous one
+ *---------------------------------------------------*/
+static void step(void)
+{
+    uint8_t last_block;
+    uint8_t bus_x;
+    uint8_t line;
+    uint8_t i;
+    uint8_t x;
+    uint8_t c;
+
+    last_block = (uint8_t)(next_block + TRANSITION_STEP_BLOCKS);
+    if(last_block > TRANSITION_BLOCK_NUM)
+    {
+        last_block = TRANSITION_BLOCK_NUM;
+    }
+
+    for(line = 0; line < 2; line++)
+    {
+        lcd_write((uint8_t)(0b01000000 | line), WRITE_COMMAND_REG);
+        bus_x = 0xFF;
+
+        for(i = next_block; i < last_block; i++)
+        {
+            x = (uint8_t)(p_order[i] * TRANSITION_BLOCK_COLUMNS);
+            if(x != bus_x)
+            {
+                lcd_write((uint8_t)(0b10000000 | x), WRITE_COMMAND_REG);
+            }
+            for(c = 0; c < TRANSITION_BLOCK_COLUMNS; c++)
+            {
+                lcd_write(column(line, (uint8_t)(x + c)), WRITE_DATA_REG);
+            }
+            bus_x = (uint8_t)(x + TRANSITION_BLOCK_COLUMNS);
+        }
+    }
+
+    next_block = last_block;
+    if(next_block == TRANSITION_BLOCK_NUM)
+    {
+        active = 0;
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef _TRANSITION_H
+#define _TRANSITION_H
+
+#if defined(__XC8)              // Not in host builds (tools/)
+#include <xc.h>
+#endif
+#include <stdint.h>
+#include "oled_lcd_lib.h"
+
+
+/* Transition Effect */
+typedef enum
+{
+    TRANSITION_CUT,             // Clear and write at once (lcd_write_graphic)
+    TRANSITION_WIPE_LEFT,       // New screen from the left edge
+    TRANSITION_WIPE_CENTER,     // New screen from the center to both edges
+} transition_t;
+
+
+/* Wipe */
+/*---------------------------------------------------
+ The new screen is written over the old one in blocks
+ of TRANSITION_BLOCK_COLUMNS, both lines, in the order
+ of a table in flash. Display is never cleared, so the
+ old screen stays until each block is replaced and no
+ blank screen is seen. Blocks are written in the
+ background at each TIMER_TRANSITION step.
+
+ | Effect      | Block order (25 blocks)            |
+ ---------------------------------------------------
+ | WIPE_LEFT   | 0, 1, 2, ... 24                    |
+ | WIPE_CENTER | 12, 11, 13, 10, 14, ... 0, 24      |
+
+ 4 blocks per 10ms step : whole screen in 60ms
+---------------------------------------------------*/
+#define TRANSITION_BLOCK_COLUMNS    (4)
+#define TRANSITION_BLOCK_NUM        (100 / TRANSITION_BLOCK_COLUMNS)
+#define TRANSITION_STEP_BLOCKS      (4)
+#define TRANSITION_STEP_MS          (10)
+
+
+/* Prototype of Function */
+/*=====================================================
+ * @brief
+ *     Write Graphic to LCD with Transition
+ * @param
+ *     p_param:pointer to write graphic parameter
+ *     effect :transition effect
+ * @return
+ *     none:
+ * @note
+ *     First step is written before return.
+ *     Message wider than the display is shown by
+ *     marquee_show() (TRANSITION_CUT).
+ *     p_message_buf must stay valid (const in flash)
+ *===================================================*/
+void transition_show(const write_graphic_param_t *p_param, transition_t effect);
+
+
+/*=====================================================
+ * @brief
+ *     Transition Task (called from main loop)
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Writes TRANSITION_STEP_BLOCKS blocks at each
+ *     TIMER_TRANSITION expiration
+ *===================================================*/
+void transition_task(void);
+
+
+/*=====================================================
+ * @brief
+ *     Check Transition in Progress
+ * @param
+ *     none:
+ * @return
+ *     1:Writing new screen, 0:Done
+ * @note
+ *     Animations wait for the end, so that the wipe
+ *     does not overwrite them
+ *===================================================*/
+uint8_t transition_busy(void);
+
+
+#endif  /* _TRANSITION_H */
@@ -1,7 +1,36 @@
+#if defined(__XC8)              // Host build : receive path only (tools/usart_fuzz.c)
 #include <xc.h>
+#include "eeprom.h"
+#include "supervisor.h"
+#endif
 #include "usart.h"
 
 
+/* Receive Buffer (filled by usart_rx_isr) */
+static volatile uint8_t rx_buf[USART_RX_BUF_SIZE];
+static volatile uint8_t rx_head;
+static volatile uint8_t rx_count;
+
+/* Receive Error Counters */
+static volatile usart_rx_stats_t rx_stats;
+
+
+#if USART_MULTIDROP
+/* Prototype of Static Function */
+#if defined(__XC8)
+static void wait_bus_idle(void);
+static void put_address(uint8_t address);
+#endif
+
+
+/* Own Address (host build : 0) */
+static uint8_t unit_address;
+#endif
+
+
+#if defined(__XC8)
+
+
 /*=====================================================
  * @breif
  *     Initialize uart
@@ -11,7 +40,7 @@
  *     void:
  * @note
  *     RC7(RX), RC6(TX)
- *     BRGH set -> High Speed Mode
+ *     BRGH, BRG16 set -> High Speed Mode (16bit)
  *==================================================*/
 void usart_init(void)
 {
@@ -20,12 +49,375 @@ void usart_init(void)
     TRISC |= 0b10000000;  // RC7 is Input
  
     /* Initialize EUSART */
-    SPBRG = SPBRG_DATA;
+    BAUDCON = BAUDCTL_BRG16;
+    usart_set_baudrate(clock_get_mode());
+#if USART_MULTIDROP
+    unit_address = eeprom_read(USART_ADDRESS_EEPROM);
+    if((unit_address == PROTOCOL_HANDSET_ADDRESS) || (unit_address == PROTOCOL_BROADCAST_ADDRESS))
+    {
+        unit_address = PROTOCOL_DEFAULT_ADDRESS;
+    }
+
+    /* Driver Disable */
+    ANSELAbits.ANSA1 = 0;
+    USART_DE    = 0;
+    USART_DE_IO = 0;
+
+    TXSTA = (TXSTA_TXEN | TXSTA_BRGH | TXSTA_TX9);
+    RCSTA = (RCSTA_SPEN | RCSTA_CREN | RCSTA_RX9 | RCSTA_ADDEN);
+#else
     TXSTA = (TXSTA_TXEN | TXSTA_BRGH);
     RCSTA = (RCSTA_SPEN | RCSTA_CREN);
+#endif
+
+    /* Enable Receive Interrupt (GIE, PEIE by button_interrupt_init()) */
+    rx_head  = 0;
+    rx_count = 0;
+    PIE1bits.RCIE = 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Set Baudrate Generator for Clock Mode
+ * @param
+ *     mode:current clock mode
+ * @return
+ *     none:
+ * @note
+ *     Called by clock_set_mode()
+ *===================================================*/
+void usart_set_baudrate(clock_mode_t mode)
+{
+    uint16_t spbrg;
+
+    switch(mode)
+    {
+        case CLOCK_MODE_IDLE:
+            spbrg = SPBRG_DATA(CLOCK_FREQ_IDLE);
+            break;
+
+        case CLOCK_MODE_FAST:
+            spbrg = SPBRG_DATA(CLOCK_FREQ_FAST);
+            break;
+
+        default:
+            spbrg = SPBRG_DATA(CLOCK_FREQ_FULL);
+            break;
+    }
+
+    SPBRGH = (uint8_t)(spbrg >> 8);
+    SPBRGL = (uint8_t)spbrg;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Wait until Transmission is completed
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     TSR is empty when TRMT is set
+ *===================================================*/
+void usart_wait_idle(void)
+{
+    /* TRMT is valid 2 cycles after writing TXREG */
+    asm("nop");
+    asm("nop");
+
+    while((TXSTA & TXSTA_TRMT) == 0)
+    {
+        ;
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Wait until Reception of a Byte is completed
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     RCIDL is clear from the start bit to the stop
+ *     bit. Bounded by USART_RX_IDLE_POLLS
+ *===================================================*/
+void usart_wait_rx_idle(void)
+{
+    uint16_t polls = USART_RX_IDLE_POLLS;
+
+    while(((BAUDCON & BAUDCTL_RCIDL) == 0) && (polls > 0))
+    {
+        polls--;
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Start Frame to Handset
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Multi-drop: wait for idle bus, enable driver and
+ *     transmit handset address and own address.
+ *     Point to Point: nothing to do
+ *===================================================*/
+void usart_begin_frame(void)
+{
+#if USART_MULTIDROP
+    wait_bus_idle();
+    USART_DE = 1;
+
+    put_address(PROTOCOL_HANDSET_ADDRESS);
+    put_char(unit_address);
+#endif
+}
+
+
+/*=====================================================
+ * @brief
+ *     End Frame to Handset
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Multi-drop: release driver after last stop bit
+ *===================================================*/
+void usart_end_frame(void)
+{
+#if USART_MULTIDROP
+    usart_wait_idle();
+    USART_DE = 0;
+#endif
+}
+
+
+/*=====================================================
+ * @brief
+ *     Transmit 1 Byte Frame to Handset
+ * @param
+ *     data:1byte data to transmit
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void usart_send_frame(uint8_t data)
+{
+    usart_begin_frame();
+    put_char(data);
+    usart_end_frame();
 }
 
 
+/*=====================================================
+ * @brief
+ *     Transmit Notification and wait for ACK
+ * @param
+ *     data:notification code
+ * @return
+ *     1:Handset received, 0:No ACK
+ * @note
+ *     Multi-drop: retried with a backoff which depends
+ *     on own address, so that colliding units are
+ *     separated. Point to Point: always 1
+ *===================================================*/
+uint8_t usart_notify(uint8_t data)
+{
+#if USART_MULTIDROP
+    uint8_t retry;
+    uint8_t wait_ms;
+    uint8_t slot;
+    uint8_t receive_data;
+
+    for(retry = 0; retry < PROTOCOL_NOTIFY_RETRY; retry++)
+    {
+        supervisor_kick();
+
+        usart_send_frame(data);
+
+        /* Wait for ACK */
+        for(wait_ms = 0; wait_ms < PROTOCOL_ACK_TIMEOUT_MS; wait_ms++)
+        {
+            if(usart_receive(&receive_data) && (receive_data == PROTOCOL_ACK))
+            {
+                return 1;
+            }
+            clock_delay_ms(1);
+        }
+
+        /* Backoff (Unit address spreads retries of colliding units), up to 320ms */
+        for(slot = 0; slot < (uint8_t)((retry + 1) * ((unit_address & 0x07) + 1)); slot++)
+        {
+            supervisor_kick();
+            clock_delay_ms(PROTOCOL_BACKOFF_SLOT_MS);
+        }
+    }
+
+    return 0;
+#else
+    put_char(data);
+
+    return 1;
+#endif
+}
+#endif  /* __XC8 */
+
+
+/*=====================================================
+ * @brief
+ *     Receive 1 Byte addressed to this Unit
+ * @param
+ *     p_data:pointer to store received data
+ * @return
+ *     1:Received, 0:Nothing
+ * @note
+ *     Does not wait if nothing is received.
+ *     Multi-drop: frames to other units are filtered
+ *     by Address Detect and never interrupt the CPU
+ *===================================================*/
+uint8_t usart_receive(uint8_t *p_data)
+{
+    uint8_t rcie;
+
+    if(rx_count == 0)
+    {
+        return 0;
+    }
+
+    /* usart_rx_isr() writes at rx_head + rx_count : both change together */
+    rcie = PIE1bits.RCIE;
+    PIE1bits.RCIE = 0;
+    *p_data = rx_buf[rx_head];
+    rx_head = (rx_head + 1) % USART_RX_BUF_SIZE;
+    rx_count--;
+    PIE1bits.RCIE = rcie;
+
+    return 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Receive Interrupt
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called by irq_dispatch() when RCIF is set.
+ *     Bytes with Framing error and Overrun are dropped
+ *     and counted, and the receiver is restarted.
+ *     Multi-drop: Data byte following an Address byte
+ *     must be accepted within 1 byte time, so Address
+ *     is checked here, not in main loop
+ *===================================================*/
+void usart_rx_isr(void)
+{
+    uint8_t status;
+    uint8_t data;
+
+    status = RCSTA;     // FERR, RX9D must be read before RCREG
+    data   = RCREG;
+
+    /* Overrun stops the receiver until CREN is cleared */
+    if(status & RCSTA_OERR)
+    {
+        RCSTA &= ~RCSTA_CREN;
+        RCSTA |= RCSTA_CREN;
+        rx_stats.overrun++;
+#if USART_MULTIDROP
+        RCSTA |= RCSTA_ADDEN;
+#endif
+        return;
+    }
+
+    /* Framing error is line noise, discard it */
+    if(status & RCSTA_FERR)
+    {
+        rx_stats.framing++;
+#if USART_MULTIDROP
+        RCSTA |= RCSTA_ADDEN;
+#endif
+        return;
+    }
+
+#if USART_MULTIDROP
+    if(status & RCSTA_RX9D)
+    {
+        /* Accept following Data byte only if addressed to this Unit */
+        if((data == unit_address) || (data == PROTOCOL_BROADCAST_ADDRESS))
+        {
+            RCSTA &= ~RCSTA_ADDEN;
+        }
+        else
+        {
+            RCSTA |= RCSTA_ADDEN;
+        }
+        return;
+    }
+
+    /* 1 Data byte per Frame */
+    RCSTA |= RCSTA_ADDEN;
+#endif
+
+    if(rx_count < USART_RX_BUF_SIZE)
+    {
+        rx_buf[(rx_head + rx_count) % USART_RX_BUF_SIZE] = data;
+        rx_count++;
+    }
+    else
+    {
+        rx_stats.dropped++;
+    }
+}
+
+
+/*=====================================================
+ * @brief
+ *     Discard all received data
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called before a request, so that noise or a late
+ *     reply to a previous request is not taken as the
+ *     answer
+ *===================================================*/
+void usart_rx_flush(void)
+{
+    PIE1bits.RCIE = 0;
+    rx_head  = 0;
+    rx_count = 0;
+    PIE1bits.RCIE = 1;
+}
+
+
+/*=====================================================
+ * @brief
+ *     Get Receive Error Counters
+ * @param
+ *     none:
+ * @return
+ *     pointer to counters (updated by usart_rx_isr)
+ * @note
+ *     Counters wrap around at 255
+ *===================================================*/
+const volatile usart_rx_stats_t *usart_get_rx_stats(void)
+{
+    return &rx_stats;
+}
+
+
+#if defined(__XC8)
 /*=====================================================
  * @breif
  *     Transmit 1 Byte data
@@ -41,7 +433,7 @@ void put_char(char byte_data)
     /* Wait until TXREG is empty */
     while(TXIF == 0)
     {
-        ;        
+        ;
     }
     
     /* Write transmitted data */
@@ -68,6 +460,7 @@ void put_string(char *str)
     }
     put_char('\0');
 }
+#endif  /* __XC8 */
 
 
 /*=====================================================
@@ -82,12 +475,67 @@ void put_string(char *str)
  *===================================================*/
 char get_char(void)
 {
-    while(RCIF == 0)
+    uint8_t receive_data;
+
+    while(usart_receive(&receive_data) == 0)
     {
         ;        
     }
  
-    return RCREG;
+    return receive_data;
 }
 
 
+
+
+#if USART_MULTIDROP && defined(__XC8)
+/*-----------------------------------------------------
+ * @brief
+ *     Wait until Bus is idle
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     RCIDL must stay set for PROTOCOL_BUS_IDLE_MS
+ *---------------------------------------------------*/
+static void wait_bus_idle(void)
+{
+    uint8_t idle_ms = 0;
+
+    while(idle_ms < PROTOCOL_BUS_IDLE_MS)
+    {
+        if(BAUDCONbits.RCIDL)
+        {
+            idle_ms++;
+        }
+        else
+        {
+            idle_ms = 0;
+        }
+        clock_delay_ms(1);
+    }
+}
+
+
+/*-----------------------------------------------------
+ * @brief
+ *     Transmit Address byte (9th bit = 1)
+ * @param
+ *     address:destination address
+ * @return
+ *     none:
+ * @note
+ *     TX9D is latched when TXREG moves to TSR, so
+ *     wait for empty TSR before changing it
+ *---------------------------------------------------*/
+static void put_address(uint8_t address)
+{
+    usart_wait_idle();
+    TXSTA |= TXSTA_TX9D;
+    TXREG  = address;
+
+    usart_wait_idle();
+    TXSTA &= ~TXSTA_TX9D;
+}
+#endif
@@ -2,14 +2,56 @@
 #define	_USART_H
 
 
+#if defined(__XC8)              // Not in host builds (tools/)
 #include <xc.h>
+#else
+/* Registers of the receive path (host build : variables of tools/usart_fuzz.c) */
+#include <stdint.h>
+typedef struct
+{
+    uint8_t RCIE;
+} usart_host_pie1_t;
+extern volatile uint8_t RCSTA;
+extern volatile uint8_t RCREG;
+extern volatile usart_host_pie1_t PIE1bits;
+#endif
 #include "pic_clock.h"
+#include "protocol.h"
 
 
 /* Setting Baudrate */
 #define BAUDRATE       (9600)       // 9.6kbps
 
 
+/* Select Link Type (can be overridden by compiler option -DUSART_MULTIDROP=1) */
+/*---------------------------------------------------
+| 0 | Point to Point, 8bit (Bluetooth transparent)  |
+-----------------------------------------------------
+| 1 | Multi-drop bus, 9bit with Address Detect      |
+---------------------------------------------------*/
+#ifndef USART_MULTIDROP
+#define USART_MULTIDROP (0)
+#endif
+
+
+/* Receive Buffer Size */
+#define USART_RX_BUF_SIZE       (8)
+
+
+/* Polls of RCIDL before a clock switch (about 2ms at CLOCK_MODE_FAST,
+   1 byte is 1.04ms at BAUDRATE; a held break line does not hang) */
+#define USART_RX_IDLE_POLLS     (1000)
+
+
+/* Unit address in Data EEPROM (Multi-drop only) */
+#define USART_ADDRESS_EEPROM    (0xC0)
+
+
+/* RS-485 Driver Enable (Multi-drop only) */
+#define USART_DE    RA1
+#define USART_DE_IO TRISAbits.TRISA1
+
+
 /* TXSTA Register Mask */
 #define TXSTA_TX9D     (1 << 0)
 #define TXSTA_TRMT     (1 << 1)
@@ -41,8 +83,17 @@
 #define BAUDCTL_ABDOVF (1 << 7)
 
 
-/* Calculate SPBRG */
-#define SPBRG_DATA ((unsigned char)((_XTAL_FREQ / BAUDRATE / 16) - 1))
+/* Receive Error Counters */
+typedef struct
+{
+    uint8_t overrun;    // OERR (receiver restarted)
+    uint8_t framing;    // FERR (byte discarded)
+    uint8_t dropped;    // Receive buffer full
+} usart_rx_stats_t;
+
+
+/* Calculate SPBRG (BRGH = 1, BRG16 = 1 : Baudrate = Fosc / (4 * (n + 1))) */
+#define SPBRG_DATA(freq) ((uint16_t)(((freq) / BAUDRATE / 4) - 1))
 
 
 /* Prototype of Function */
@@ -55,11 +106,168 @@
  *     void:
  * @note
  *     RC7(RX), RC6(TX)
- *     BRGH set -> High Speed Mode
+ *     BRGH, BRG16 set -> High Speed Mode (16bit)
  *==================================================*/
 void usart_init(void);
 
 
+/*=====================================================
+ * @brief
+ *     Set Baudrate Generator for Clock Mode
+ * @param
+ *     mode:current clock mode
+ * @return
+ *     none:
+ * @note
+ *     Called by clock_set_mode()
+ *===================================================*/
+void usart_set_baudrate(clock_mode_t mode);
+
+
+/*=====================================================
+ * @brief
+ *     Wait until Transmission is completed
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     TSR is empty when TRMT is set
+ *===================================================*/
+void usart_wait_idle(void);
+
+
+/*=====================================================
+ * @brief
+ *     Wait until Reception of a Byte is completed
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     RCIDL is clear from the start bit to the stop
+ *     bit. Bounded by USART_RX_IDLE_POLLS
+ *===================================================*/
+void usart_wait_rx_idle(void);
+
+
+/*=====================================================
+ * @brief
+ *     Start Frame to Handset
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Multi-drop: wait for idle bus, enable driver and
+ *     transmit handset address and own address.
+ *     Point to Point: nothing to do
+ *===================================================*/
+void usart_begin_frame(void);
+
+
+/*=====================================================
+ * @brief
+ *     End Frame to Handset
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Multi-drop: release driver after last stop bit
+ *===================================================*/
+void usart_end_frame(void);
+
+
+/*=====================================================
+ * @brief
+ *     Transmit 1 Byte Frame to Handset
+ * @param
+ *     data:1byte data to transmit
+ * @return
+ *     none:
+ * @note
+ *     none
+ *===================================================*/
+void usart_send_frame(uint8_t data);
+
+
+/*=====================================================
+ * @brief
+ *     Transmit Notification and wait for ACK
+ * @param
+ *     data:notification code
+ * @return
+ *     1:Handset received, 0:No ACK
+ * @note
+ *     Multi-drop: retried with a backoff which depends
+ *     on own address, so that colliding units are
+ *     separated. Point to Point: always 1
+ *===================================================*/
+uint8_t usart_notify(uint8_t data);
+
+
+/*=====================================================
+ * @brief
+ *     Receive 1 Byte addressed to this Unit
+ * @param
+ *     p_data:pointer to store received data
+ * @return
+ *     1:Received, 0:Nothing
+ * @note
+ *     Does not wait if nothing is received.
+ *     Multi-drop: frames to other units are filtered
+ *     by Address Detect and never interrupt the CPU
+ *===================================================*/
+uint8_t usart_receive(uint8_t *p_data);
+
+
+/*=====================================================
+ * @brief
+ *     Receive Interrupt
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called by irq_dispatch() when RCIF is set.
+ *     Bytes with Framing error and Overrun are dropped
+ *     and counted, and the receiver is restarted.
+ *     Multi-drop: Data byte following an Address byte
+ *     must be accepted within 1 byte time, so Address
+ *     is checked here, not in main loop
+ *===================================================*/
+void usart_rx_isr(void);
+
+
+/*=====================================================
+ * @brief
+ *     Discard all received data
+ * @param
+ *     none:
+ * @return
+ *     none:
+ * @note
+ *     Called before a request, so that noise or a late
+ *     reply to a previous request is not taken as the
+ *     answer
+ *===================================================*/
+void usart_rx_flush(void);
+
+
+/*=====================================================
+ * @brief
+ *     Get Receive Error Counters
+ * @param
+ *     none:
+ * @return
+ *     pointer to counters (updated by usart_rx_isr)
+ * @note
+ *     Counters wrap around at 255
+ *===================================================*/
+const volatile usart_rx_stats_t *usart_get_rx_stats(void);
+
+
 /*=====================================================
  * @breif
  *     Transmit 1 Byte data
@@ -1,6 +1,14 @@
 #include <xc.h>
 #include "word_graphic.h"
 #include "oled_lcd_lib.h"
+#include "transition.h"
+#include "perf.h"
+#include "language.h"
+#include "font.h"
+
+
+/* Prototype of Static Function */
+static void write_message(uint8_t id, transition_t effect);
 
 
 /*=====================================================
@@ -15,116 +23,9 @@
  *===================================================*/
 void write_default_message(void)
 {
-    /* Default Message HEAD */    
-    const uint8_t default_message[] =
-    {
-        0x00      ,  //
-        0b00100000,  //   *
-        0b01010010,  //  * *  *
-        0b01000011,  //  *    **
-        0b01000010,  //  *    *
-        0b01000001,  //  *     *
-        0x00      ,  //
-        0b01111111,  //  *******
-        0b00010101,  //    * * *
-        0b01111111,  //   ******
-        0b00010101,  //    * * *
-        0b01111111,  //  *******
-        0x00      ,  //
-        0b00111100,  //   ****
-        0b00100010,  //   *   *
-        0b00011110,  //    ****
-        0b01000010,  //  *    *
-        0b00111100,  //   ****
-        0x00      ,  //
-        0b01000010,  //  *    *
-        0b00111110,  //   *****
-        0b00001011,  //     * **
-        0b01001010,  //  *  * *
-        0b01111010,  //  **** *
-        0x00      ,  //
-        0b01111111,  //  *******
-        0b00100000,  //   *
-        0b01010100,  //  * * *
-        0b00111111,  //   ******
-        0b00100100,  //   *  *
-        0x00      ,  //
-        0b00100000,  //   *
-        0b01000000   //  *
-    	0x00      ,  // 
-    	0b00110100,  //   ** *
-        0b00000100,  //      *
-        0b01111111,  //  *******
-        0b00000100,  //      *
-        0b00110101,  //   ** * *
-        0x00      ,  //
-        0b01001000,  //  *  *
-        0b01000100,  //  *   *
-        0b00101011,  //   * * **
-        0b00010010,  //    *  *
-        0b00001110,  //     ***
-        0x00      ,  //
-        0b01000001,  //  *     *
-        0b01000010,  //  *    *
-        0b00100000,  //   *
-        0b00010000,  //    *
-        0b00001100,  //     **
-        0x00      ,  //
-        0b00010010,  //    *  *
-        0b00101110,  //   *  ***
-        0b01011011,  //  *  ** **
-        0b01001010,  //  *  * *
-        0b01010100,  //  * * *   
-        0x00      ,  //
-        0b01010010,  //  * *  *
-        0b01111111,  //  *******
-        0b00011111,  //   ******
-        0b01110101,  //  *** * *
-        0b00111111,  //   ******
-        0x00      ,  //
-        0b00000000,  //
-        0b00111111,  //   ******
-        0b01000000,  //  *
-        0b01000000,  //  *
-        0b00100000,  //   *
-        0x00      ,  //
-        0b00000010,  //       *
-        0b00000010,  //       *
-        0b00011101,  //    *** *
-        0b00100011,  //   *   **
-        0b01000001,  //  *     *
-        0x00      ,  //
-        0b00000001,  //        *
-        0b00000001,  //        *
-        0b01111111,  //  *******
-        0b00000101,  //      * *
-        0b00001001,  //     *  *
-        0x00      ,  //
-        0b00100100,  //   *  *
-        0b01010100,  //  * * *
-        0b01000111,  //  *   ***
-        0b01011100,  //  * ***
-        0b00000100,  //      *
-        0x00      ,  //
-        0b00111110,  //   *****
-        0b01000000,  //  *
-        0b00100000,  //   *
-        0b00000010,  //       *
-        0b00011100,  //    ***
-        0x00      ,  //
-        0b00100000,  //   *
-        0b01010000,  //  * *
-        0b00100000   //   *   
-    };
-
-    write_graphic_param_t default_m;
-    
-    default_m.x_axis_address = 0b10000000;
-    default_m.y_axis_address = 0b01000000;
-    default_m.message_buf    = default_message;
-    default_m.message_len    = sizeof(default_message) / sizeof(uint8_t);
-    
-    lcd_write_graphic(&default_m);
+    PERF_BEGIN(PERF_DEFAULT_MESSAGE);
+    write_message(MESSAGE_DEFAULT, TRANSITION_WIPE_LEFT);
+    PERF_END(PERF_DEFAULT_MESSAGE);
 }
 
 
@@ -140,43 +41,9 @@ void write_default_message(void)
  *===================================================*/
 void write_call_message(void)
 {
-    /* Call Message */
-    const uint8_t call_message[] = 
-    {
-        0x00     ,   //
-        0b0011110,   //   ****
-        0b00011110,  //    ****
-        0b01010010,  //  * *  *
-        0b01111110,  //  ******
-        0b00010101,  //    * * *
-        0x00      ,  //
-        0b01110110,  //  *** **
-        0b01000100,  //  *   *
-        0b01111111,  //  *******
-        0b01000100,  //  *   *
-        0b01110110,  //  **  **
-        0x00      ,  //
-        0b00011110,  //    ****
-        0b00010010,  //    *  *
-        0b01111111,  //  *******
-        0b00010010,  //    *  *
-        0b00011110,  //    ****
-        0x00      ,  //
-        0b00010000,  //    *
-        0x00      ,  //
-        0b00010000,  //    *
-        0x00      ,  //
-        0b00010000   //    *
-    };
-
-    write_graphic_param_t call_m;
-    
-    call_m.x_axis_address = 0b10000000;
-    call_m.y_axis_address = 0b01000000;
-    call_m.message_buf    = call_message;
-    call_m.message_len    = sizeof(call_message) / sizeof(uint8_t);
-    
-    lcd_write_graphic(&call_m);
+    PERF_BEGIN(PERF_CALL_MESSAGE);
+    write_message(MESSAGE_CALL, TRANSITION_WIPE_CENTER);
+    PERF_END(PERF_CALL_MESSAGE);
 }
 
 
@@ -192,58 +59,9 @@ void write_call_message(void)
  *===================================================*/
 void write_not_here_message(void)
 {
-    /* Not be here Message */
-    const uint8_t not_here_message[] = 
-    {
-        0x00      ,  //    
-        0b00010100,  //    * *  
-        0b01010010,  //  * *  * 
-        0b01010101,  //  * * * *
-        0b00110110,  //   ** ** 
-        0b00010100,  //    * *
-        0x00      ,  //
-        0b00110010,  //   **  *
-        0b01111111,  //  *******
-        0b00001010,  //     * *
-        0b01001001,  //  *  *  *
-        0b00110010,  //   **  *
-        0x00      ,  //
-        0b00001111,  //     ****
-        0b01000010,  //  *    *
-        0b00100001,  //   *    *
-        0b00011110,  //    ****
-        0x00      ,  //
-        0b01101010,  //  ** * *
-        0b01101010,  //  ** * *
-        0b01111111,  //  *******
-        0b00101010,  //   * * *
-        0b01001010,  //  *  * *
-        0x00      ,  // 
-        0b00000100,  //      *
-        0b00111111,  //   ******
-        0b01000100,  //  *   *
-        0b01011111,  //  * *****
-        0b01000100,  //  *   *
-        0x00      ,  //
-        0b01100000,  //  **
-        0b00011100,  //    ***
-        0b00110011,  //   **  **
-        0b01000000,  //  *
-        0b00100000,  //   *
-        0x00      ,  //
-        0b00100000,  //   *
-        0b01010000,  //  * *
-        0b00100000   //   *   
-    };
-    
-    write_graphic_param_t not_here_m;
-    
-    not_here_m.x_axis_address = 0b10000000;
-    not_here_m.y_axis_address = 0b01000000;
-    not_here_m.message_buf    = not_here_message;
-    not_here_m.message_len    = sizeof(not_here_message) / sizeof(uint8_t);
-    
-    lcd_write_graphic(&not_here_m);
+    PERF_BEGIN(PERF_NOT_HERE_MESSAGE);
+    write_message(MESSAGE_NOT_HERE, TRANSITION_WIPE_CENTER);
+    PERF_END(PERF_NOT_HERE_MESSAGE);
 }
 
 
@@ -251,115 +69,70 @@ void write_not_here_message(void)
  * @brief
  *     Write Responce Message to LCD
  * @param
- *     responce:Choose Responce1 or 2
+ *     id:Responce id (responce.h)
  * @return
  *     none:
  * @note
- *     none
+ *     Message of the selected language (language.h)
  *===================================================*/
-void write_responce_message(responce_t responce)
+void write_responce_message(uint8_t id)
 {
-    /* Responce1 "今参ります。" */
-    const uint8_t responce_1[] = 
+    if(id >= RESPONCE_NUM)
     {
-        0x00      ,  //    
-        0b00010100,  //    * *  
-        0b01010010,  //  * *  * 
-        0b01010101,  //  * * * *
-        0b00110110,  //   ** ** 
-        0b00010100,  //    * *
-        0x00      ,  //
-        0b00010100,  //    * *
-        0b01001110,  //  *  ***
-        0b01010101,  //  * * * *
-        0b00101100,  //   * **
-        0b00010110,  //    * **
-        0x00      ,  //
-        0b00000000,  //
-        0b00001111,  //     ****
-        0b01000010,  //  *    *
-        0b00100001,  //   *    *
-        0b00011110,  //    ****
-        0x00      ,  //
-        0b01101010,  //  ** * *
-        0b01101010,  //  ** * *
-        0b01111111,  //  *******
-        0b00101010,  //   * * *
-        0b01001010,  //  *  * *
-        0x00      ,  //
-        0b00000010,  //       *
-        0b00001010,  //     * *
-        0b01010110,  //  * * **
-        0b00111111,  //   ******
-        0b00000010,  //       *
-        0b00100000,  //   *
-        0b01010000,  //  * *
-        0b00100000   //   *
-    };
+        return;
+    }
+
+    PERF_BEGIN(PERF_RESPONCE_MESSAGE);
+    write_message((uint8_t)(MESSAGE_RESPONCE + id), TRANSITION_WIPE_CENTER);
+    PERF_END(PERF_RESPONCE_MESSAGE);
+}
 
 
-/* Responce2 "お入りください。" */
-    const uint8_t responce_2[] =
+/*-----------------------------------------------------
+ * @brief
+ *     Write Message of Selected Language
+ * @param
+ *     id    :message_id_t
+ *     effect:transition of graphic data
+ * @return
+ *     none:
+ * @note
+ *     Text is cleared at once and drawn with the font,
+ *     from line 0 to line 1
+ *---------------------------------------------------*/
+static void write_message(uint8_t id, transition_t effect)
+{
+    const message_t *p_message = language_message(id);
+    const uint16_t *p_text;
+    write_graphic_param_t message_m;
+    uint8_t len;
+
+    message_m.x_axis_address = 0b10000000;
+    message_m.y_axis_address = 0b01000000;
+    message_m.p_message_buf  = (const uint8_t *)p_message->p_data;
+    message_m.message_len    = p_message->len;
+
+    if(p_message->kind == MESSAGE_BITMAP)
     {
-        0x00      ,  //
-        0b00110010,  //   **  *
-        0b01111111,  //  *******
-        0b00001010,  //     * *
-        0b01001001,  //  *  *  *
-        0b00110010,  //   **  *
-        0x00      ,  //
-        0b01000000,  //  *
-        0b00110001,  //   **   *
-        0b00001111,  //     ****
-        0b00110000,  //   **
-        0b01000000,  //  *
-        0x00      ,  //
-        0b00000000,  //
-        0b00001111,  //     ****
-        0b01000010,  //  *    *
-        0b00100001,  //   *    *
-        0b00011110,  //    ****
-        0x00      ,  //
-        0b00000001,  //        *
-        0b00000001,  //        *
-        0b01111111,  //  *******
-        0b00000101,  //      * *
-        0b00001001,  //     *  *
-        0x00      ,  //
-        0b00100100,  //   *  *
-        0b01010100,  //  * * *
-        0b01000111,  //  *   ***
-        0b01011100,  //  * ***
-        0b00000100,  //      *
-        0x00      ,  //
-        0b00111110,  //   *****
-        0b01000000,  //  *
-        0b00100000,  //   *
-        0b00000010,  //       *
-        0b00011100,  //    ***
-        0x00      ,  //
-        0b00100000,  //   *
-        0b01010000,  //  * *
-        0b00100000   //   *   
-    };
+        transition_show(&message_m, effect);
+        return;
+    }
+
+    /* Clear (stops wipe and marquee) */
+    message_m.message_len = 0;
+    transition_show(&message_m, TRANSITION_CUT);
 
-    write_graphic_param_t responce_m;
-    
-    responce_m.x_axis_address = 0b10000000;
-    responce_m.y_axis_address = 0b01000000;
-    
-    /* Write Responce Message */
-    if(responce == RESPONCE1)
+    p_text = (const uint16_t *)p_message->p_data;
+    len    = p_message->len;
+    if(len > FONT_LINE_CHARS)
     {
-        /* Write Responce 1 */
-        responce_m.buf         = responce_1;
-        responce_m.message_len = sizeof(responce_1) / sizeof(uint8_t);
+        font_write_text(0, 0, p_text, FONT_LINE_CHARS);
+        p_text += FONT_LINE_CHARS;
+        len    -= FONT_LINE_CHARS;
+        font_write_text(0, 1, p_text, (len > FONT_LINE_CHARS) ? FONT_LINE_CHARS : len);
     }
     else
     {
-        /* Write Responce 2 */
-        responce_m.buf         = responce_2;
-        responce_m.message_len = sizeof(responce_2) / sizeof(uint8_t);
+        font_write_text(0, 0, p_text, len);
     }
-    lcd_write_graphic(&responce_m);
 }
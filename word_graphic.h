@@ -3,14 +3,7 @@
 
 
 #include <xc.h>
-
-
-/* Responce Type */
-typedef enum
-{
-    RESPONCE1,
-    RESPONCE2,    
-} responce_t;
+#include <stdint.h>
 
 
 /* Prototype of Function */
@@ -57,13 +50,13 @@ void write_not_here_message(void);
  * @brief
  *     Write Responce Message to LCD
  * @param
- *     responce:Choose RESPONCE1 or 2
+ *     id:Responce id (responce.h)
  * @return
  *     none:
  * @note
- *     none
+ *     Message of the selected language (language.h)
  *===================================================*/
-void write_responce_message(responce_t responce);
+void write_responce_message(uint8_t id);
 
 
 #endif